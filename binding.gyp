@@ -11,6 +11,7 @@
                 'src/core/edge-selectors.cpp',
                 'src/core/EdgeHolder.cpp',
                 'src/core/equation-solver.cpp',
+                'src/core/FlatShape.cpp',
                 'src/core/msdf-error-correction.cpp',
                 'src/core/MSDFErrorCorrection.cpp',
                 'src/core/msdfgen.cpp',
@@ -23,7 +24,15 @@
                 'src/core/sdf-error-estimation.cpp',
                 'src/core/shape-description.cpp',
                 'src/core/Shape.cpp',
+                'src/core/ShapeEdgeGrid.cpp',
                 'src/msdf_wrap.cc',
+                'src/atlas_packer.cc',
+                'src/font_session.cc',
+                'src/glyph_cache.cc',
+                'src/glyph_render.cc',
+                'src/mapped_file.cc',
+                'src/svg_document.cc',
+                'src/work_stealing.cc',
                 'src/ext/import-font.cpp',
                 'src/ext/import-svg.cpp',
                 'src/ext/resolve-shape-geometry.cpp',
@@ -0,0 +1,28 @@
+import { buildMetadata, processFont } from '../lib'
+
+import type { FontGlyphMap } from '../lib'
+
+// time buildMetadata on a ligature heavy font with its substitute list repeated 1 to 16 times;
+// the time per substitute should stay flat if serialization is linear
+// usage: ts-node buildScripts/benchMetadata.ts [fontPath]
+const FONT = process.argv[2] ?? './openFonts/noto/NotoSansDevanagari-Regular.ttf'
+const RUNS = 10
+
+async function main (): Promise<void> {
+  const font = await processFont('bench', { fontPaths: [FONT] })
+  console.log(`${FONT}: ${font.glyphs.length} glyphs, ${font.substitutes.length} substitutes\n`)
+  for (const scale of [1, 2, 4, 8, 16]) {
+    const map: FontGlyphMap = {
+      ...font,
+      substitutes: Array.from({ length: scale }, () => font.substitutes).flat()
+    }
+    buildMetadata(map) // warm up
+    const start = process.hrtime.bigint()
+    for (let i = 0; i < RUNS; i++) buildMetadata(map)
+    const ms = Number(process.hrtime.bigint() - start) / 1e6 / RUNS
+    const perThousand = ms / map.substitutes.length * 1000
+    console.log(`${map.substitutes.length} substitutes: ${ms.toFixed(2)} ms (${perThousand.toFixed(3)} ms per 1k)`)
+  }
+}
+
+main().catch((err): void => { console.log(err) })
@@ -0,0 +1,27 @@
+import { load } from 'opentype.js'
+import { compareQuadraticSearch } from '../lib'
+
+import type { Type } from '../lib'
+
+// render the glyphs of a TrueType font (all quadratic curves) solving a cubic equation for the closest point,
+// and refining the one of the previous pixel instead, and report the speedup and the largest 8-bit difference per type
+// usage: ts-node buildScripts/benchQuadraticSearch.ts [fontPath] [size] [maxGlyphs]
+const FONT = process.argv[2] ?? './test/features/fonts/Roboto/Roboto-Medium.ttf'
+const SIZE = Number(process.argv[3] ?? 128)
+const MAX_GLYPHS = Number(process.argv[4] ?? 2000)
+const RANGE = 6
+const TYPES: Type[] = ['sdf', 'psdf', 'msdf', 'mtsdf']
+
+async function main (): Promise<void> {
+  const { numGlyphs } = await load(FONT)
+  const indices = new Uint32Array(Math.min(numGlyphs, MAX_GLYPHS)).map((_, i) => i)
+  console.log(`${FONT}: ${indices.length} of ${numGlyphs} glyphs at size ${SIZE}, range ${RANGE}\n`)
+  for (const type of TYPES) {
+    const { glyphs, bytes, differingBytes, maxDifference, maxDifferenceIndex, referenceMs, testMs } = compareQuadraticSearch(FONT, indices, SIZE, RANGE, type)
+    const speedup = testMs > 0 ? referenceMs / testMs : 0
+    const worst = maxDifference > 0 ? ` (glyph ${maxDifferenceIndex})` : ''
+    console.log(`${type}: ${glyphs} glyphs, solved ${referenceMs.toFixed(0)} ms, seeded ${testMs.toFixed(0)} ms (${speedup.toFixed(2)}x), ${differingBytes} of ${bytes} bytes differ, max difference ${maxDifference}${worst}`)
+  }
+}
+
+main().catch((err): void => { console.log(err) })
@@ -1,4 +1,4 @@
-import { generateGlyphs } from '../lib'
+import { finalizeSQL, generateGlyphs } from '../lib'
 import fs from 'fs'
 
 const NOTO_FONTS = JSON.parse(fs.readFileSync('./openFonts/noto-fonts.json', 'utf8'))
@@ -80,6 +80,8 @@ async function main (): Promise<void> {
       multi: true
     }
   }).catch((err): void => { console.log(err) })
+  // compact the shared database once every font is in
+  finalizeSQL('./GLYPHS_V2.sqlite')
 
   // // TESTING NOTO MEDIUM
   // console.log('\nNOTO MEDIUM')
@@ -7,6 +7,8 @@ export type EmptyObject = Record<string, never>
 
 export interface MSDFResponse {
   data: ArrayBuffer
+  /** channels per pixel in `data`: 4 (RGBA) unless the glyph was rendered packed */
+  channels: number
   width: number
   height: number
   shapeSize: number
@@ -23,15 +25,187 @@ export type buildFontGlyphSpec = (
   size: number,
   range: number,
   type: Type,
-  codeIsIndex: boolean
+  codeIsIndex: boolean,
+  /** keep only the type's own channels (1 for sdf/psdf, 3 for msdf, 4 for mtsdf) instead of RGBA */
+  packed?: boolean
 ) => MSDFResponse | EmptyObject
+/** glyph flag: the code is a glyph index rather than a unicode value */
+export const GLYPH_FLAG_INDEX = 1
+/** number of Int32 entries per glyph in `MSDFBatchResponse.sizes` */
+export const GLYPH_BATCH_SIZES = 4
+/** number of Float64 entries per glyph in `MSDFBatchResponse.metrics` */
+export const GLYPH_BATCH_METRICS = 6
+export interface MSDFBatchResponse {
+  /** pixel data of every rendered glyph, back to back, each preceded by `headerSize` reserved bytes */
+  data: ArrayBuffer
+  /** per glyph: width, height, byte offset of its pixels in `data` (-1 if the glyph failed), byte length */
+  sizes: Int32Array
+  /** per glyph: emSize, l, r, t, b, advance */
+  metrics: Float64Array
+  /** channels per pixel of every glyph in `data` */
+  channels: number
+  lineHeight: number
+}
+export type buildFontGlyphsSpec = (
+  fontPath: string,
+  codes: Uint32Array,
+  flags: Uint8Array,
+  size: number,
+  range: number,
+  type: Type,
+  /** number of native worker threads. Defaults to one per core */
+  threads?: number,
+  /** bytes reserved in front of every glyph's pixels so a header can be written in place */
+  headerSize?: number,
+  /** keep only the type's own channels (1 for sdf/psdf, 3 for msdf, 4 for mtsdf) instead of RGBA */
+  packed?: boolean,
+  /** directory of the on-disk render cache (must exist). Unchanged glyphs are copied from it instead of rendered */
+  cacheDir?: string
+) => MSDFBatchResponse
+export type buildFontGlyphsAsyncSpec = (
+  fontPath: string,
+  codes: Uint32Array,
+  flags: Uint8Array,
+  size: number,
+  range: number,
+  type: Type,
+  /** number of native worker threads. Defaults to one per core */
+  threads?: number,
+  /** bytes reserved in front of every glyph's pixels so a header can be written in place */
+  headerSize?: number,
+  /** keep only the type's own channels (1 for sdf/psdf, 3 for msdf, 4 for mtsdf) instead of RGBA */
+  packed?: boolean,
+  /** called on the main thread as glyphs finish. Intermediate counts may be skipped */
+  onProgress?: (done: number, total: number) => void,
+  cacheDir?: string
+) => Promise<MSDFBatchResponse>
+export interface FontSession {
+  /** Render a glyph from the open font. Same output as `buildFontGlyph` without reloading the font */
+  buildGlyph: (
+    code: number,
+    size: number,
+    range: number,
+    type: Type,
+    codeIsIndex: boolean,
+    packed?: boolean
+  ) => MSDFResponse | EmptyObject
+  /** Render many glyphs in one call. Same output as `buildFontGlyphs` without reloading the font */
+  buildGlyphs: (
+    codes: Uint32Array,
+    flags: Uint8Array,
+    size: number,
+    range: number,
+    type: Type,
+    threads?: number,
+    headerSize?: number,
+    packed?: boolean,
+    cacheDir?: string
+  ) => MSDFBatchResponse
+  /** Release the native font handles. The session can not be used afterwards */
+  close: () => void
+}
+export type FontSessionSpec = new (fontPath: string) => FontSession
 export type buildSVGGlyphSpec = (
   svgPath: string,
   size: number,
   range: number,
   pathIndex: number,
-  type: Type
+  type: Type,
+  packed?: boolean
 ) => MSDFResponse | EmptyObject
+export type buildSVGGlyphAsyncSpec = (
+  svgPath: string,
+  size: number,
+  range: number,
+  pathIndex: number,
+  type: Type,
+  packed?: boolean
+) => Promise<MSDFResponse | EmptyObject>
+export type buildSVGGlyphsSpec = (
+  svgPath: string,
+  /** paths to render, numbered from 0 in document order (`pathIndex - 1` of `buildSVGGlyph`) */
+  pathIndices: Uint32Array,
+  size: number,
+  range: number,
+  type: Type,
+  /** number of native worker threads. Defaults to one per core */
+  threads?: number,
+  /** bytes reserved in front of every glyph's pixels so a header can be written in place */
+  headerSize?: number,
+  /** keep only the type's own channels (1 for sdf/psdf, 3 for msdf, 4 for mtsdf) instead of RGBA */
+  packed?: boolean,
+  /** render cache directory, as for `buildFontGlyphs` */
+  cacheDir?: string
+) => MSDFBatchResponse
+export type buildSVGGlyphsAsyncSpec = (
+  svgPath: string,
+  pathIndices: Uint32Array,
+  size: number,
+  range: number,
+  type: Type,
+  threads?: number,
+  headerSize?: number,
+  packed?: boolean,
+  cacheDir?: string
+) => Promise<MSDFBatchResponse>
+/** number of Int32 entries per rectangle in `AtlasPacking.placements` */
+export const ATLAS_PLACEMENT_SIZE = 3
+export interface AtlasPacking {
+  /** per rectangle: page, x, y of its top left corner; page is -1 if it is empty or larger than a page */
+  placements: Int32Array
+  /** number of pages used */
+  pages: number
+}
+export type packAtlasSpec = (
+  widths: Uint32Array,
+  heights: Uint32Array,
+  pageWidth: number,
+  pageHeight: number,
+  /** pixels kept free between neighbouring rectangles. Defaults to 0 */
+  padding?: number
+) => AtlasPacking
+export type mapFileSpec = (filePath: string) => ArrayBuffer
+export interface RenderComparison {
+  /** glyphs rendered (empty glyphs are skipped) */
+  glyphs: number
+  /** bytes of output compared */
+  bytes: number
+  /** bytes that differ between the reference and the test render */
+  differingBytes: number
+  /** largest difference of any byte, in 8-bit levels */
+  maxDifference: number
+  /** index of the glyph holding the largest difference */
+  maxDifferenceIndex: number
+  /** time spent rendering the reference */
+  referenceMs: number
+  /** time spent rendering the test */
+  testMs: number
+}
+export type compareRendersSpec = (
+  fontPath: string,
+  glyphIndices: Uint32Array,
+  size: number,
+  range: number,
+  type: Type
+) => RenderComparison
 
 export const buildFontGlyph = msdfNative.buildFontGlyph as buildFontGlyphSpec
+/** Render a list of glyphs from one font in a single native call */
+export const buildFontGlyphs = msdfNative.buildFontGlyphs as buildFontGlyphsSpec
 export const buildSVGGlyph = msdfNative.buildSVGGlyph as buildSVGGlyphSpec
+/** Keeps a font open natively so that many glyphs can be rendered without re-parsing the font file */
+export const FontSession = msdfNative.FontSession as FontSessionSpec
+/** Same as `buildFontGlyphs` but renders off the main thread */
+export const buildFontGlyphsAsync = msdfNative.buildFontGlyphsAsync as buildFontGlyphsAsyncSpec
+/** Same as `buildSVGGlyph` but renders off the main thread */
+export const buildSVGGlyphAsync = msdfNative.buildSVGGlyphAsync as buildSVGGlyphAsyncSpec
+/** Render many paths of one SVG file, parsing the file only once. `lineHeight` of the result is 0 */
+export const buildSVGGlyphs = msdfNative.buildSVGGlyphs as buildSVGGlyphsSpec
+/** Same as `buildSVGGlyphs` but renders off the main thread */
+export const buildSVGGlyphsAsync = msdfNative.buildSVGGlyphsAsync as buildSVGGlyphsAsyncSpec
+/** Lay rectangles out on atlas pages (skyline bottom-left, tallest first) */
+export const packAtlas = msdfNative.packAtlas as packAtlasSpec
+/** Map a file read-only into memory. Its pages load as they are touched; the buffer must not be written to */
+export const mapFile = msdfNative.mapFile as mapFileSpec
+/** Render glyphs with the cubic equation (reference) and the seeded search (test, the default) for the closest point on quadratic curves and report how far apart they are */
+export const compareQuadraticSearch = msdfNative.compareQuadraticSearch as compareRendersSpec
@@ -0,0 +1,40 @@
+import fs from 'fs'
+import path from 'path'
+
+/** extension of the entries the native renderer writes (see src/glyph_cache.h) */
+const CACHE_ENTRY_EXTENSION = '.sdf'
+
+/** Create the render cache directory if it does not exist yet */
+export function openGlyphCache (directory: string): void {
+  fs.mkdirSync(directory, { recursive: true })
+}
+
+/**
+ * Evict the least recently used renders until the cache holds at most `maxBytes`. Hits refresh an
+ * entry's modification time, so the oldest entries go first. Stray temporary files left by an
+ * interrupted build are removed as well. Returns the number of bytes left in the cache.
+ */
+export function pruneGlyphCache (directory: string, maxBytes: number): number {
+  if (!fs.existsSync(directory)) return 0
+  const entries: Array<{ file: string, size: number, mtime: number }> = []
+  let total = 0
+  for (const name of fs.readdirSync(directory)) {
+    const file = path.join(directory, name)
+    if (name.endsWith('.tmp')) {
+      fs.rmSync(file, { force: true })
+      continue
+    }
+    if (!name.endsWith(CACHE_ENTRY_EXTENSION)) continue
+    const { size, mtimeMs } = fs.statSync(file)
+    entries.push({ file, size, mtime: mtimeMs })
+    total += size
+  }
+  if (total <= maxBytes) return total
+  entries.sort((a, b) => a.mtime - b.mtime)
+  for (const { file, size } of entries) {
+    if (total <= maxBytes) break
+    fs.rmSync(file, { force: true })
+    total -= size
+  }
+  return total
+}
@@ -1 +1,2 @@
 export * from './sdf'
+export * from './glyphCache'
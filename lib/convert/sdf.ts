@@ -1,14 +1,67 @@
 import { stdout as log } from 'single-line-log'
-import { buildFontGlyph, buildSVGGlyph } from '../binding'
+import {
+  GLYPH_BATCH_METRICS,
+  GLYPH_BATCH_SIZES,
+  GLYPH_FLAG_INDEX,
+  buildFontGlyphs,
+  buildFontGlyphsAsync,
+  buildSVGGlyphs,
+  buildSVGGlyphsAsync
+} from '../binding'
+import { openGlyphCache, pruneGlyphCache } from './glyphCache'
 import { zigzag } from '../util/zigzag'
 
-import type { GlyphMap } from '../process/index'
+import type { MSDFBatchResponse } from '../binding'
+import type { Glyph, GlyphMap } from '../process/index'
 
 export type SDF_TYPES = 'sdf' | 'psdf' | 'msdf' | 'mtsdf'
 
 export interface SDFOptions {
   /** type of SDF to convert to. Default is 'mtsdf' */
   convertType?: SDF_TYPES
+  /** number of native threads used to render font glyphs. Default is 0 (one per core) */
+  threads?: number
+  /**
+   * pad every glyph to RGBA. Default is false: only the channels the type carries are stored
+   * (1 for sdf/psdf, 3 for msdf, 4 for mtsdf)
+   */
+  rgba?: boolean
+  /**
+   * directory of an on-disk render cache shared across builds. Glyphs whose outline and render
+   * parameters are unchanged are copied from it instead of rendered. Default is no cache
+   */
+  cacheDir?: string
+  /** size the cache is pruned back to after each conversion, least recently used first. Default is 1 GiB */
+  cacheMaxBytes?: number
+}
+
+/** default `SDFOptions.cacheMaxBytes` */
+export const GLYPH_CACHE_MAX_BYTES = 1024 * 1024 * 1024
+
+/** where a font glyph's render lives inside its font's batch */
+interface BatchedGlyph {
+  batch: MSDFBatchResponse
+  index: number
+}
+
+/** size of the metadata header in front of every stored glyph */
+export const GLYPH_HEADER_SIZE = 14
+
+/** channels each SDF type carries when stored packed */
+export const SDF_CHANNELS: Record<SDF_TYPES, number> = { sdf: 1, psdf: 1, msdf: 3, mtsdf: 4 }
+
+/** a rendered glyph as the conversion loop consumes it */
+interface RenderedGlyph {
+  data?: Uint8Array
+  /** header + data, if the renderer reserved room for the header in front of the pixels */
+  blob?: Buffer
+  width: number
+  height: number
+  r: number
+  l: number
+  t: number
+  b: number
+  emSize: number
 }
 
 export function convertGlyphsToSDF (
@@ -16,33 +69,168 @@ export function convertGlyphsToSDF (
   options: SDFOptions,
   consoleLog = false
 ): void {
-  const { glyphs } = glyphMap
+  const { glyphs, size, range } = glyphMap
   const notDeadGlyphs = glyphs.filter((glyph) => !glyph.dead)
-  const { length } = notDeadGlyphs
   const convertType = options.convertType ?? 'mtsdf'
-  let count = 0
+  const threads = options.threads ?? 0
+  const packed = options.rgba !== true
+  const { cacheDir } = options
+  glyphMap.channels = packed ? SDF_CHANNELS[convertType] : 4
+  console.info('\nConverting glyphs to SDF...\n')
+  if (cacheDir !== undefined) openGlyphCache(cacheDir)
+  const batched = new Map<Glyph, BatchedGlyph>()
+  for (const { file, list, codes, flags } of groupFontGlyphs(notDeadGlyphs)) {
+    const batch = buildFontGlyphs(file, codes, flags, size, range, convertType, threads, GLYPH_HEADER_SIZE, packed, cacheDir)
+    list.forEach((glyph, index) => batched.set(glyph, { batch, index }))
+  }
+  for (const { file, list, indices } of groupSVGGlyphs(notDeadGlyphs)) {
+    const batch = buildSVGGlyphs(file, indices, size, range, convertType, threads, GLYPH_HEADER_SIZE, packed, cacheDir)
+    list.forEach((glyph, index) => batched.set(glyph, { batch, index }))
+  }
+  if (cacheDir !== undefined) pruneGlyphCache(cacheDir, options.cacheMaxBytes ?? GLYPH_CACHE_MAX_BYTES)
+  convertGlyphs(glyphMap, notDeadGlyphs, consoleLog, (glyph) => unpackBatchedGlyph(batched.get(glyph) as BatchedGlyph))
+}
+
+/**
+ * Same result as `convertGlyphsToSDF`, but all rendering happens off the main thread so the
+ * event loop stays free. Each SVG file renders as one batch, the files concurrently on the libuv
+ * pool, while font glyphs render one font at a time, each spread over the native worker threads.
+ */
+export async function convertGlyphsToSDFAsync (
+  glyphMap: GlyphMap,
+  options: SDFOptions,
+  consoleLog = false
+): Promise<void> {
+  const { glyphs, size, range } = glyphMap
+  const notDeadGlyphs = glyphs.filter((glyph) => !glyph.dead)
+  const convertType = options.convertType ?? 'mtsdf'
+  const threads = options.threads ?? 0
+  const packed = options.rgba !== true
+  const { cacheDir } = options
+  glyphMap.channels = packed ? SDF_CHANNELS[convertType] : 4
   console.info('\nConverting glyphs to SDF...\n')
-  for (const glyph of notDeadGlyphs) {
+  if (cacheDir !== undefined) openGlyphCache(cacheDir)
+  const rendered = new Map<Glyph, RenderedGlyph>()
+  const renderFonts = async (): Promise<void> => {
+    for (const { file, list, codes, flags } of groupFontGlyphs(notDeadGlyphs)) {
+      const onProgress = consoleLog
+        ? (done: number, total: number) => { log(`${file}: ${done} / ${total}`) }
+        : undefined
+      const batch = await buildFontGlyphsAsync(file, codes, flags, size, range, convertType, threads, GLYPH_HEADER_SIZE, packed, onProgress, cacheDir)
+      list.forEach((glyph, index) => rendered.set(glyph, unpackBatchedGlyph({ batch, index })))
+    }
+  }
+  // the files already render concurrently, so each batch keeps to a single thread
+  const renderSVGs = groupSVGGlyphs(notDeadGlyphs).map(async ({ file, list, indices }) => {
+    const batch = await buildSVGGlyphsAsync(file, indices, size, range, convertType, 1, GLYPH_HEADER_SIZE, packed, cacheDir)
+    list.forEach((glyph, index) => rendered.set(glyph, unpackBatchedGlyph({ batch, index })))
+  })
+  await Promise.all([renderFonts(), ...renderSVGs])
+  if (cacheDir !== undefined) pruneGlyphCache(cacheDir, options.cacheMaxBytes ?? GLYPH_CACHE_MAX_BYTES)
+  convertGlyphs(glyphMap, notDeadGlyphs, consoleLog, (glyph) => rendered.get(glyph) as RenderedGlyph)
+}
+
+/** a font file's glyphs with the codes and flags to render them in one native call */
+interface FontGlyphGroup {
+  file: string
+  list: Glyph[]
+  codes: Uint32Array
+  flags: Uint8Array
+}
+
+function groupFontGlyphs (glyphs: Glyph[]): FontGlyphGroup[] {
+  const byFile = new Map<string, Glyph[]>()
+  for (const glyph of glyphs) {
+    if (glyph.type !== 'unicode' && glyph.type !== 'substitution') continue
+    let list = byFile.get(glyph.file)
+    if (list === undefined) {
+      list = []
+      byFile.set(glyph.file, list)
+    }
+    list.push(glyph)
+  }
+  const groups: FontGlyphGroup[] = []
+  for (const [file, list] of byFile) {
+    const codes = new Uint32Array(list.length)
+    const flags = new Uint8Array(list.length)
+    list.forEach((glyph, index) => {
+      if (glyph.type === 'unicode') codes[index] = glyph.unicode
+      else if (glyph.type === 'substitution') {
+        codes[index] = glyph.code
+        flags[index] = GLYPH_FLAG_INDEX
+      }
+    })
+    groups.push({ file, list, codes, flags })
+  }
+  return groups
+}
+
+/** an SVG file's glyphs with the indices of their paths, to render from one parse of the file */
+interface SVGGlyphGroup {
+  file: string
+  list: Glyph[]
+  indices: Uint32Array
+}
+
+function groupSVGGlyphs (glyphs: Glyph[]): SVGGlyphGroup[] {
+  const byFile = new Map<string, Glyph[]>()
+  for (const glyph of glyphs) {
+    if (glyph.type !== 'svg') continue
+    let list = byFile.get(glyph.file)
+    if (list === undefined) {
+      list = []
+      byFile.set(glyph.file, list)
+    }
+    list.push(glyph)
+  }
+  const groups: SVGGlyphGroup[] = []
+  for (const [file, list] of byFile) {
+    const indices = new Uint32Array(list.map((glyph) => glyph.type === 'svg' ? glyph.pathIndex : 0))
+    groups.push({ file, list, indices })
+  }
+  return groups
+}
+
+/** view a glyph of a batch, and the header room in front of it, without copying its pixels */
+function unpackBatchedGlyph ({ batch, index }: BatchedGlyph): RenderedGlyph {
+  const { data, sizes, metrics } = batch
+  const s = index * GLYPH_BATCH_SIZES
+  const m = index * GLYPH_BATCH_METRICS
+  const [width, height, offset, length] = sizes.subarray(s, s + GLYPH_BATCH_SIZES)
+  const [emSize, l, r, t, b] = metrics.subarray(m, m + GLYPH_BATCH_METRICS)
+  return {
+    data: offset < 0 ? undefined : new Uint8Array(data, offset, length),
+    blob: offset < 0 ? undefined : Buffer.from(data, offset - GLYPH_HEADER_SIZE, GLYPH_HEADER_SIZE + length),
+    width,
+    height,
+    r,
+    l,
+    t,
+    b,
+    emSize
+  }
+}
+
+function convertGlyphs (
+  glyphMap: GlyphMap,
+  glyphs: Glyph[],
+  consoleLog: boolean,
+  render: (glyph: Glyph) => RenderedGlyph
+): void {
+  const { length } = glyphs
+  let count = 0
+  for (const glyph of glyphs) {
     if (consoleLog) log(`${++count} / ${length}`)
     // prep variables
     const { round } = Math
-    const { extent, size, range } = glyphMap
-    const { dead, type, file } = glyph
+    const { extent } = glyphMap
+    const { dead, type } = glyph
     if (dead) continue
     if (type === 'image') continue
     let buffer = Buffer.alloc(0)
     // STEP 1) BUILD AND CREATE METADATA
     // create the sdf, psdf, msdf or mtsdf
-    let { data, width, height, r, l, t, b, emSize } = (type === 'svg')
-      ? buildSVGGlyph(file, size, range, glyph.pathIndex + 1, convertType)
-      : buildFontGlyph(
-        file,
-        type === 'unicode' ? glyph.unicode : glyph.code,
-        size,
-        range,
-        convertType,
-        type === 'substitution'
-      )
+    let { data, blob, width, height, r, l, t, b, emSize } = render(glyph)
     r = round(r / emSize * extent)
     l = round(l / emSize * extent)
     t = round(t / emSize * extent)
@@ -51,7 +239,7 @@ export function convertGlyphsToSDF (
     // update height
       glyphMap.maxHeight = Math.max(height, glyphMap.maxHeight)
       // bufferize
-      buffer = Buffer.from(data)
+      buffer = Buffer.from(data.buffer, data.byteOffset, data.byteLength)
       // update glyph information
       glyph.width = r - l // size * ceil(width / extent) = texture-width
       glyph.height = t - b // size * ceil(height / extent) = texture-height
@@ -74,7 +262,13 @@ export function convertGlyphsToSDF (
     if (glyphAdvanceWidth < 0 || glyphAdvanceWidth > 65535) { glyph.dead = true; continue }
 
     // STEP 2: STORE METADATA AND IMAGE DATA
-    const meta = Buffer.alloc(14)
+    // write the header in place when the renderer left room for it, otherwise bundle
+    let glyphBuffer = blob
+    if (glyphBuffer === undefined) {
+      glyphBuffer = Buffer.alloc(GLYPH_HEADER_SIZE + buffer.length)
+      buffer.copy(glyphBuffer, GLYPH_HEADER_SIZE)
+    }
+    const meta = glyphBuffer
     meta.writeUInt16LE('unicode' in glyph ? glyph.unicode : 0, 0)
     meta.writeUInt16LE(glyph.width, 2)
     meta.writeUInt16LE(glyph.height, 4)
@@ -84,8 +278,6 @@ export function convertGlyphsToSDF (
     meta.writeUInt16LE(glyphYOffset, 10)
     meta.writeUInt16LE(glyphAdvanceWidth, 12)
 
-    // bundle
-    const glyphBuffer = Buffer.concat([meta, buffer])
     glyph.length = glyphBuffer.length
     // store the result into the glyph
     glyph.imageBuffer = buffer
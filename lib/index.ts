@@ -1,6 +1,6 @@
-import { convertGlyphsToSDF } from './convert'
+import { convertGlyphsToSDFAsync } from './convert'
 import { processFont, processSVG, processImages } from './process'
-import { storeGlyphsToSQL } from './storage'
+import { storeGlyphsToPack, storeGlyphsToRanges, storeGlyphsToSQL, storeGlyphsToSpriteSheet } from './storage'
 
 import type {
   FontOptions,
@@ -12,7 +12,10 @@ import type {
   SDFOptions
 } from './convert'
 import type {
-  SQLiteOptions
+  PackOptions,
+  RangeOptions,
+  SQLiteOptions,
+  SpriteSheetOptions
 } from './storage'
 
 export * from './convert'
@@ -30,8 +33,8 @@ export interface Options {
   processOptions: FontOptions | SVGOptions | ImageOptions
   /** Convert options is not required if you're only using image data */
   convertOptions?: SDFOptions
-  /** Store as an SQL DB, spritesheet image/json combo, or range table */
-  storeOptions: SQLiteOptions
+  /** Store as an SQL DB, a memory mappable pack file, static range files, or sprite sheet pages with a json index */
+  storeOptions: SQLiteOptions | PackOptions | RangeOptions | SpriteSheetOptions
 }
 
 export async function generateGlyphs (options: Options): Promise<void> {
@@ -44,9 +47,12 @@ export async function generateGlyphs (options: Options): Promise<void> {
   if (glyphMap === undefined) throw new Error('No glyphMap was created')
   // 2) convert glyphs to sdf, image, or vector as needed
   if (convertOptions !== undefined) {
-    if ('convertType' in convertOptions) convertGlyphsToSDF(glyphMap, convertOptions, log)
+    if ('convertType' in convertOptions) await convertGlyphsToSDFAsync(glyphMap, convertOptions, log)
   }
   // 3) store glyphs
   if (storeOptions.storeType === 'SQL') storeGlyphsToSQL(name, glyphMap, storeOptions, log)
+  if (storeOptions.storeType === 'PACK') await storeGlyphsToPack(name, glyphMap, storeOptions)
+  if (storeOptions.storeType === 'RANGES') await storeGlyphsToRanges(name, glyphMap, storeOptions)
+  if (storeOptions.storeType === 'SPRITESHEET') await storeGlyphsToSpriteSheet(name, glyphMap, storeOptions)
   console.info('\ndone')
 }
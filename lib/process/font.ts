@@ -1,3 +1,4 @@
+import { createHash } from 'crypto'
 import { load } from 'opentype.js'
 import { stdout as log } from 'single-line-log'
 
@@ -7,6 +8,7 @@ import type {
   CoverageFormat2,
 
   FontGlyphMap,
+  Glyph,
   GlyphBase,
   Lookup,
   Substitute
@@ -60,13 +62,16 @@ export async function processFont (
     range,
     size,
     maxHeight: 0,
-    substitutes: []
+    substitutes: [],
+    aliases: new Map<number, number>()
   }
+  // outline hash => unicode of the glyph stored for it, shared by all fonts
+  const outlines = new Map<string, number>()
 
   // parse all fonts, if glyph already is stored, then it isn't read again.
   // In other words, whichever font goes first gets precedence on the glyph used.
   for (const path of fontPaths) {
-    await parseFont(path, fontGlyphMap, consoleLog)
+    await parseFont(path, fontGlyphMap, outlines, consoleLog)
   }
 
   return fontGlyphMap
@@ -76,6 +81,7 @@ export async function processFont (
 async function parseFont (
   path: string,
   fontGlyphMap: FontGlyphMap,
+  outlines: Map<string, number>,
   consoleLog: boolean
 ): Promise<void> {
   if (consoleLog) log(`parsing ${path}`)
@@ -88,41 +94,73 @@ async function parseFont (
   const glyphs = font.glyphs.glyphs as GlyphSet
 
   // first pass - store all glpyhs that contain a unicode
-  storeUnicodeGlyphs(glyphs, fontGlyphMap, path, mul)
+  storeUnicodeGlyphs(glyphs, fontGlyphMap, outlines, path, unitsPerEm, mul)
   // second pass - store all substitutes
   buildSubstitutes(font, glyphs, fontGlyphMap, path, mul)
 }
 
+/**
+ * Each outline is stored once: the other code points of a glyph, and code points whose glyph has
+ * the same outline and advance as one already stored (lookalikes across fallback fonts), become
+ * aliases of the stored unicode instead of glyphs of their own.
+ */
 function storeUnicodeGlyphs (
   glyphs: GlyphData,
   fontGlyphMap: FontGlyphMap,
+  outlines: Map<string, number>,
   path: string,
+  unitsPerEm: number,
   mul: number
 ): void {
   for (const glyph of Object.values(glyphs)) {
     const { unicodes } = glyph
+    let outline: string | undefined
+    // the unicode this glyph is rendered under, if it isn't dead
+    let target: number | undefined
     for (const unicode of unicodes) {
       const code = String(unicode)
       const hasCode: boolean = fontGlyphMap.glyphSet.has(code)
       if (
-        !isNaN(unicode) &&
-        unicode >= 0 &&
-        unicode <= 65535 &&
-        !hasCode
-      ) {
-        storeGlyph({ unicode }, glyph as FontGlyph, fontGlyphMap, path, mul)
+        isNaN(unicode) ||
+        unicode < 0 ||
+        unicode > 65535 ||
+        hasCode
+      ) continue
+      if (target === undefined) {
+        outline ??= hashOutline(glyph, unitsPerEm)
+        target = outlines.get(outline)
+      }
+      if (target !== undefined) {
+        fontGlyphMap.aliases.set(unicode, target)
+        fontGlyphMap.glyphSet.add(code)
+        continue
+      }
+      const stored = storeGlyph({ unicode }, glyph as FontGlyph, fontGlyphMap, path, mul)
+      if (!stored.dead) {
+        target = unicode
+        outlines.set(outline as string, unicode)
       }
     }
   }
 }
 
+/** hash of everything that shapes a glyph's render and header: the outline in em units and the advance */
+function hashOutline (glyph: GeneratedOpenTypeGlyph, unitsPerEm: number): string {
+  const hash = createHash('sha1')
+  hash.update(`${unitsPerEm};${glyph.advanceWidth ?? 0};`)
+  for (const { type, x1, y1, x2, y2, x, y } of glyph.path.commands as Array<Record<string, number | string | undefined>>) {
+    hash.update(`${type as string}${x1 ?? ''},${y1 ?? ''},${x2 ?? ''},${y2 ?? ''},${x ?? ''},${y ?? ''};`)
+  }
+  return hash.digest('hex')
+}
+
 function storeGlyph (
   input: { unicode: number } | { code: number, id: string },
   glyph: FontGlyph,
   fontGlyphMap: FontGlyphMap,
   file: string,
   mul: number
-): void {
+): Glyph {
   const isUnicode = 'unicode' in input
   const id = isUnicode ? String(input.unicode) : input.id
   const { round, abs } = Math
@@ -152,23 +190,15 @@ function storeGlyph (
     imageBuffer: Buffer.alloc(0),
     glyphBuffer: Buffer.alloc(0)
   }
-  if (isUnicode) {
-    fontGlyphMap.glyphs.push({
-      ...base,
-      type: 'unicode',
-      unicode: input.unicode
-    })
-  } else {
-    fontGlyphMap.glyphs.push({
-      ...base,
-      type: 'substitution',
-      code: input.code
-    })
-  }
+  const stored: Glyph = isUnicode
+    ? { ...base, type: 'unicode', unicode: input.unicode }
+    : { ...base, type: 'substitution', code: input.code }
+  fontGlyphMap.glyphs.push(stored)
   fontGlyphMap.glyphSet.add(id)
   if (isUnicode && input.unicode === 32 && fontGlyphMap.defaultAdvance === -1) {
     fontGlyphMap.defaultAdvance = round(advanceWidth * mul)
   }
+  return stored
 }
 
 async function loadFont (path: string): Promise<Font | undefined> {
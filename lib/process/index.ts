@@ -93,6 +93,8 @@ export interface GlyphMapBase {
   maxHeight: number
   /** range of the font */
   range: number
+  /** channels per pixel of the stored glyphs; set when converting. Defaults to 4 (RGBA) */
+  channels?: number
 }
 
 export interface FontGlyphMap extends GlyphMapBase {
@@ -100,6 +102,8 @@ export interface FontGlyphMap extends GlyphMapBase {
   type: 'font'
   /** substitutes. Only used by fonts */
   substitutes: Substitute[]
+  /** unicode => unicode of the stored glyph with the same outline; aliases are not rendered or stored */
+  aliases: Map<number, number>
 }
 
 export interface PathID {
@@ -1,8 +1,9 @@
 import fs from 'fs'
+import { createHash } from 'crypto'
 import { getSVGData } from '../util/elementParser'
 import { stdout as log } from 'single-line-log'
 
-import type { Glyph, PathID, SVGGlyph, SVGGlyphMap } from './'
+import type { PathID, SVGGlyph, SVGGlyphMap } from './'
 import type { Color } from '../util/elementParser'
 
 export interface SVGOptions {
@@ -54,6 +55,8 @@ function parseSVGs (path: string, svgGlyphMap: SVGGlyphMap, consoleLog: boolean)
 
   const length = svgs.length
   let count = 1
+  // path geometry hash => glyph code
+  const glyphCodes = new Map<string, number>()
 
   // build svg paths
   for (const svg of svgs) {
@@ -64,18 +67,21 @@ function parseSVGs (path: string, svgGlyphMap: SVGGlyphMap, consoleLog: boolean)
     // prep a path ID array
     const pathIDs: PathID[] = []
     // store each path
-    for (const { index, path, color } of pathData) {
+    for (const { index, path, elements, color } of pathData) {
       // if color doesn't exist, add it
       let colorID = findColorIndex(color, svgGlyphMap.colors)
       if (colorID === -1) {
         colorID = svgGlyphMap.colors.length
         svgGlyphMap.colors.push(color)
       }
-      // if glyphs doesn't have the path, add it
-      let glyphID: number = findGlyphCode(path, svgGlyphMap.glyphs)
-      if (glyphID === -1) {
+      // if glyphs doesn't have the path, add it. Paths are compared by their parsed commands, so
+      // the same geometry written with different number formatting or separators is stored once
+      const geometry = createHash('sha1').update(JSON.stringify(elements)).digest('hex')
+      let glyphID = glyphCodes.get(geometry)
+      if (glyphID === undefined) {
         const len: number = svgGlyphMap.glyphs.length
         glyphID = len + 1
+        glyphCodes.set(geometry, glyphID)
         svgGlyphMap.glyphs.push(buildGlyph(pathName, glyphID, path, index))
       }
       // store the path ID
@@ -123,11 +129,3 @@ function findColorIndex (json: Color, arr: Color[]): number {
   }
   return -1
 }
-
-function findGlyphCode (path: string, glyphs: Glyph[]): number {
-  for (const glyph of glyphs) {
-    if (glyph.type !== 'svg') continue
-    if (path === glyph.path) return glyph.code
-  }
-  return -1
-}
@@ -1,24 +1,24 @@
+-- Schema version 2 (PRAGMA user_version): glyph and metadata blobs keyed by (name, code).
+-- Version 1 stored the blobs as base64 TEXT in rowid tables; readers still accept those values
+-- and builds migrate the tables in place.
 BEGIN;
 
 CREATE TABLE IF NOT EXISTS glyph (
-    code TEXT NOT NULL,
-    data TEXT -- base64 encoded string of Uint8Array
-);
+    code TEXT NOT NULL PRIMARY KEY,
+    data BLOB -- glyph header + pixels
+) WITHOUT ROWID;
 
 CREATE TABLE IF NOT EXISTS glyph_multi (
-    name TEXT,
+    name TEXT NOT NULL,
     code TEXT NOT NULL,
-    data TEXT -- base64 encoded string of Uint8Array
-);
+    data BLOB, -- glyph header + pixels
+    PRIMARY KEY (name, code)
+) WITHOUT ROWID;
 
 CREATE TABLE IF NOT EXISTS metadata (
-    name TEXT,
-    data TEXT -- base64 encoded string of Uint8Array
-);
-
-CREATE UNIQUE INDEX IF NOT EXISTS glyph_index ON glyph (code);
-CREATE UNIQUE INDEX IF NOT EXISTS glyph_multi_index ON glyph_multi (name, code);
-CREATE UNIQUE INDEX IF NOT EXISTS meta_index ON metadata (name);
+    name TEXT NOT NULL PRIMARY KEY,
+    data BLOB -- serialized metadata
+) WITHOUT ROWID;
 
 CREATE VIEW IF NOT EXISTS glyphs AS
     SELECT
@@ -1 +1,4 @@
+export * from './pack'
+export * from './ranges'
+export * from './spriteSheet'
 export * from './sql'
@@ -0,0 +1,187 @@
+import fs from 'fs'
+import path from 'path'
+import { mapFile } from '../binding'
+import { aliasGlyphBuffer, buildMetadata, parseMetadata } from './sql'
+
+import type { GlyphMap } from '../process/index'
+import type { Metadata } from './sql'
+
+export interface PackOptions {
+  /** Type of storage */
+  storeType: 'PACK'
+  /** folder to write into; each map is stored as <name>.glyphs */
+  out: string
+}
+
+// GLYPH PACK
+// a read-only container for serving, mapped into memory instead of parsed
+// 0: magic "GLPK"
+// 4: version (writeUInt32LE)
+// 8: metadata offset, 12: metadata length (writeUInt32LE) - the `buildMetadata` blob
+// 16: unicode count, 20: unicode index offset (writeUInt32LE)
+// 24: named count, 28: named index offset (writeUInt32LE)
+// 32+: metadata, indices, glyph blobs (header + pixels as stored in SQL)
+//
+// UNICODE INDEX - sorted by unicode, aliases point at a copy of the glyph they share with their own unicode in its header
+// [repeating] unicode, blob offset, blob length (writeUInt32LE)
+//
+// NAMED INDEX - every other code (substitutes, svg/image ids), sorted by code
+// [repeating] code offset, code length, blob offset, blob length (writeUInt32LE); codes are UTF-8
+// and sorted by their bytes
+
+export const GLYPH_PACK_MAGIC = 'GLPK'
+export const GLYPH_PACK_VERSION = 2
+const HEADER_SIZE = 32
+const UNICODE_ENTRY_SIZE = 12
+const NAMED_ENTRY_SIZE = 16
+
+/** Write the map into one pack file */
+export async function storeGlyphsToPack (
+  name: string,
+  map: GlyphMap,
+  options: PackOptions
+): Promise<void> {
+  await fs.promises.mkdir(options.out, { recursive: true })
+  await fs.promises.writeFile(path.join(options.out, `${name}.glyphs`), buildGlyphPack(map))
+}
+
+/** the pack file of a map */
+export function buildGlyphPack (map: GlyphMap): Buffer {
+  const metadata = buildMetadata(map)
+  const unicodes: Array<{ code: number, blob: Buffer }> = []
+  const named: Array<{ code: Buffer, blob: Buffer }> = []
+  const byUnicode = new Map<number, Buffer>()
+  for (const glyph of map.glyphs) {
+    if (glyph.dead || glyph.glyphBuffer.length === 0) continue
+    if (glyph.type === 'unicode') {
+      unicodes.push({ code: glyph.unicode, blob: glyph.glyphBuffer })
+      byUnicode.set(glyph.unicode, glyph.glyphBuffer)
+    } else {
+      named.push({ code: Buffer.from(glyph.id, 'utf8'), blob: glyph.glyphBuffer })
+    }
+  }
+  if ('aliases' in map) {
+    for (const [unicode, target] of map.aliases) {
+      const blob = byUnicode.get(target)
+      if (blob !== undefined) unicodes.push({ code: unicode, blob: aliasGlyphBuffer(unicode, blob) })
+    }
+  }
+  // unicode blobs (alias copies included) come first, then named ones; the indices refer to them by offset
+  const blobs = [...unicodes, ...named].map(({ blob }) => blob)
+  unicodes.sort((a, b) => a.code - b.code)
+  named.sort((a, b) => Buffer.compare(a.code, b.code))
+
+  const codesLength = named.reduce((sum, { code }) => sum + code.length, 0)
+  const metadataOffset = HEADER_SIZE
+  const unicodeIndexOffset = metadataOffset + metadata.length
+  const namedIndexOffset = unicodeIndexOffset + unicodes.length * UNICODE_ENTRY_SIZE
+  const codesOffset = namedIndexOffset + named.length * NAMED_ENTRY_SIZE
+  const blobsOffset = codesOffset + codesLength
+  const blobOffsets = new Map<Buffer, number>()
+  let size = blobsOffset
+  for (const blob of blobs) {
+    blobOffsets.set(blob, size)
+    size += blob.length
+  }
+
+  const pack = Buffer.alloc(size)
+  pack.write(GLYPH_PACK_MAGIC, 0, 'latin1')
+  pack.writeUInt32LE(GLYPH_PACK_VERSION, 4)
+  pack.writeUInt32LE(metadataOffset, 8)
+  pack.writeUInt32LE(metadata.length, 12)
+  pack.writeUInt32LE(unicodes.length, 16)
+  pack.writeUInt32LE(unicodeIndexOffset, 20)
+  pack.writeUInt32LE(named.length, 24)
+  pack.writeUInt32LE(namedIndexOffset, 28)
+  metadata.copy(pack, metadataOffset)
+  unicodes.forEach(({ code, blob }, i) => {
+    const pos = unicodeIndexOffset + i * UNICODE_ENTRY_SIZE
+    pack.writeUInt32LE(code, pos)
+    pack.writeUInt32LE(blobOffsets.get(blob) as number, pos + 4)
+    pack.writeUInt32LE(blob.length, pos + 8)
+  })
+  let codePos = codesOffset
+  named.forEach(({ code, blob }, i) => {
+    const pos = namedIndexOffset + i * NAMED_ENTRY_SIZE
+    pack.writeUInt32LE(codePos, pos)
+    pack.writeUInt32LE(code.length, pos + 4)
+    pack.writeUInt32LE(blobOffsets.get(blob) as number, pos + 8)
+    pack.writeUInt32LE(blob.length, pos + 12)
+    codePos += code.copy(pack, codePos)
+  })
+  for (const [blob, offset] of blobOffsets) blob.copy(pack, offset)
+
+  return pack
+}
+
+/**
+ * Serve glyphs out of a pack file. The file is memory mapped, so opening only reads the header,
+ * and `getGlyph` hands out views of the mapping (read only) after a binary search of the index
+ */
+export class GlyphPackReader {
+  readonly data: Buffer
+  readonly #unicodeCount: number
+  readonly #unicodeIndex: number
+  readonly #namedCount: number
+  readonly #namedIndex: number
+  #metadata?: Metadata
+
+  constructor (file: string | Buffer) {
+    this.data = typeof file === 'string' ? Buffer.from(mapFile(file)) : file
+    const { data } = this
+    if (data.length < HEADER_SIZE || data.toString('latin1', 0, 4) !== GLYPH_PACK_MAGIC) {
+      throw new Error('Not a glyph pack')
+    }
+    const version = data.readUInt32LE(4)
+    if (version !== GLYPH_PACK_VERSION) throw new Error(`Unsupported glyph pack version: ${version}`)
+    this.#unicodeCount = data.readUInt32LE(16)
+    this.#unicodeIndex = data.readUInt32LE(20)
+    this.#namedCount = data.readUInt32LE(24)
+    this.#namedIndex = data.readUInt32LE(28)
+  }
+
+  /** the pack's metadata, parsed on first use */
+  get metadata (): Metadata {
+    if (this.#metadata === undefined) {
+      const offset = this.data.readUInt32LE(8)
+      this.#metadata = parseMetadata(this.data.subarray(offset, offset + this.data.readUInt32LE(12)))
+    }
+    return this.#metadata
+  }
+
+  /** header + pixels of a glyph, as `getGlyph` of the SQL store returns it, without copying */
+  getGlyph (code: string): Buffer | undefined {
+    const { data } = this
+    if (/^\d+$/.test(code)) {
+      const unicode = Number(code)
+      let lo = 0
+      let hi = this.#unicodeCount - 1
+      while (lo <= hi) {
+        const mid = (lo + hi) >>> 1
+        const pos = this.#unicodeIndex + mid * UNICODE_ENTRY_SIZE
+        const value = data.readUInt32LE(pos)
+        if (value === unicode) return this.#blob(pos + 4)
+        if (value < unicode) lo = mid + 1
+        else hi = mid - 1
+      }
+    }
+    const key = Buffer.from(code, 'utf8')
+    let lo = 0
+    let hi = this.#namedCount - 1
+    while (lo <= hi) {
+      const mid = (lo + hi) >>> 1
+      const pos = this.#namedIndex + mid * NAMED_ENTRY_SIZE
+      const start = data.readUInt32LE(pos)
+      const order = Buffer.compare(data.subarray(start, start + data.readUInt32LE(pos + 4)), key)
+      if (order === 0) return this.#blob(pos + 8)
+      if (order < 0) lo = mid + 1
+      else hi = mid - 1
+    }
+    return undefined
+  }
+
+  #blob (pos: number): Buffer {
+    const offset = this.data.readUInt32LE(pos)
+    return this.data.subarray(offset, offset + this.data.readUInt32LE(pos + 4))
+  }
+}
@@ -1 +1,193 @@
-// NOTE: may never be supported
+import fs from 'fs'
+import path from 'path'
+import Pbf from 'pbf'
+import { GLYPH_RANGE_SIZE, buildMetadata } from './sql'
+import { zigzag } from '../util/zigzag'
+
+import type { GlyphMap } from '../process/index'
+import type { ParsedGlyph } from './sql'
+
+export interface RangeOptions {
+  /** Type of storage */
+  storeType: 'RANGES'
+  /** folder to write into; each map gets a folder of its own named after it */
+  out: string
+}
+
+// RANGE FILES
+// <out>/<name>/<start>-<end>.pbf for every 256 code points holding at least one glyph, like the
+// glyph ranges of Mapbox GL, so a CDN can serve them as static files. Substitutes have no code
+// point and share <out>/<name>/substitutes.pbf. <out>/<name>/metadata is the `buildMetadata` blob
+//
+// the messages follow Mapbox's glyphs.proto, with the stored values in place of Mapbox's metrics:
+// glyphs { repeated fontstack stacks = 1 }
+// fontstack { name = 1 (string), range = 2 (string), repeated glyph glyphs = 3 }
+// glyph {
+//   id = 1 (uint32, unicode or svg/image code; 0 for substitutes)
+//   bitmap = 2 (bytes, texture pixels)
+//   width = 3, height = 4 (uint32, texture width and height)
+//   left = 5, top = 6 (sint32, x and y offset)
+//   advance = 7 (uint32, advance width)
+//   extentWidth = 8, extentHeight = 9 (uint32, glyph width and height in extent units)
+//   code = 10 (string, substitutes only)
+// }
+
+/** a glyph of a range file as written */
+interface RangeGlyph {
+  id: number
+  code?: string
+  bitmap: Uint8Array
+  texWidth: number
+  texHeight: number
+  xOffset: number
+  yOffset: number
+  advanceWidth: number
+  width: number
+  height: number
+}
+
+interface RangeStack {
+  name: string
+  range: string
+  glyphs: RangeGlyph[]
+}
+
+/** Write every glyph of the map into range files. The files are written concurrently */
+export async function storeGlyphsToRanges (
+  name: string,
+  map: GlyphMap,
+  options: RangeOptions
+): Promise<void> {
+  const folder = path.join(options.out, name)
+  await fs.promises.mkdir(folder, { recursive: true })
+
+  const ranges = new Map<number, RangeGlyph[]>()
+  const substitutes: RangeGlyph[] = []
+  const byUnicode = new Map<number, RangeGlyph>()
+  const addToRange = (glyph: RangeGlyph): void => {
+    const start = glyph.id - (glyph.id % GLYPH_RANGE_SIZE)
+    let list = ranges.get(start)
+    if (list === undefined) {
+      list = []
+      ranges.set(start, list)
+    }
+    list.push(glyph)
+  }
+  for (const glyph of map.glyphs) {
+    if (glyph.dead || glyph.glyphBuffer.length === 0) continue
+    const rangeGlyph: RangeGlyph = {
+      id: glyph.type === 'substitution' ? 0 : Number(glyph.id),
+      code: glyph.type === 'substitution' ? glyph.id : undefined,
+      bitmap: glyph.glyphBuffer.subarray(14),
+      texWidth: glyph.texWidth,
+      texHeight: glyph.texHeight,
+      xOffset: glyph.xOffset,
+      yOffset: glyph.yOffset,
+      // Mapbox's advance is unsigned
+      advanceWidth: Math.max(0, glyph.advanceWidth),
+      width: glyph.width,
+      height: glyph.height
+    }
+    if (glyph.type === 'substitution') substitutes.push(rangeGlyph)
+    else {
+      addToRange(rangeGlyph)
+      if (glyph.type === 'unicode') byUnicode.set(glyph.unicode, rangeGlyph)
+    }
+  }
+  // a range file stands alone, so aliases carry a copy of the glyph they share
+  if ('aliases' in map) {
+    for (const [unicode, target] of map.aliases) {
+      const glyph = byUnicode.get(target)
+      if (glyph !== undefined) addToRange({ ...glyph, id: unicode })
+    }
+  }
+
+  const writes: Array<Promise<void>> = []
+  for (const [start, glyphs] of ranges) {
+    const range = `${start}-${start + GLYPH_RANGE_SIZE - 1}`
+    writes.push(writeRangeFile(path.join(folder, `${range}.pbf`), { name, range, glyphs }))
+  }
+  if (substitutes.length > 0) {
+    writes.push(writeRangeFile(path.join(folder, 'substitutes.pbf'), { name, range: 'substitutes', glyphs: substitutes }))
+  }
+  writes.push(fs.promises.writeFile(path.join(folder, 'metadata'), buildMetadata(map)))
+  await Promise.all(writes)
+}
+
+async function writeRangeFile (file: string, stack: RangeStack): Promise<void> {
+  stack.glyphs.sort((a, b) => a.id - b.id)
+  const pbf = new Pbf()
+  pbf.writeMessage(1, writeStack, stack)
+  await fs.promises.writeFile(file, pbf.finish())
+}
+
+function writeStack (stack: RangeStack, pbf: Pbf): void {
+  pbf.writeStringField(1, stack.name)
+  pbf.writeStringField(2, stack.range)
+  for (const glyph of stack.glyphs) pbf.writeMessage(3, writeGlyph, glyph)
+}
+
+function writeGlyph (glyph: RangeGlyph, pbf: Pbf): void {
+  pbf.writeVarintField(1, glyph.id)
+  pbf.writeBytesField(2, glyph.bitmap)
+  pbf.writeVarintField(3, glyph.texWidth)
+  pbf.writeVarintField(4, glyph.texHeight)
+  pbf.writeSVarintField(5, glyph.xOffset)
+  pbf.writeSVarintField(6, glyph.yOffset)
+  pbf.writeVarintField(7, glyph.advanceWidth)
+  pbf.writeVarintField(8, glyph.width)
+  pbf.writeVarintField(9, glyph.height)
+  if (glyph.code !== undefined) pbf.writeStringField(10, glyph.code)
+}
+
+/** Read the glyphs of a range file in the form `parseGlyphBuffer` gives a stored glyph */
+export function parseGlyphRange (data: Uint8Array): ParsedGlyph[] {
+  const glyphs: ParsedGlyph[] = []
+  const pbf = new Pbf(data)
+  pbf.readFields((tag, _, pbf) => {
+    if (tag === 1) pbf.readMessage(readStackField, glyphs)
+  }, glyphs)
+  return glyphs
+}
+
+function readStackField (tag: number, glyphs: ParsedGlyph[], pbf: Pbf): void {
+  if (tag !== 3) return
+  const glyph = pbf.readMessage(readGlyphField, {
+    id: 0,
+    bitmap: new Uint8Array(0),
+    texWidth: 0,
+    texHeight: 0,
+    xOffset: 0,
+    yOffset: 0,
+    advanceWidth: 0,
+    width: 0,
+    height: 0
+  } as RangeGlyph)
+  const texels = glyph.texWidth * glyph.texHeight
+  glyphs.push({
+    code: glyph.code ?? String(glyph.id),
+    unicode: glyph.id,
+    texW: glyph.texWidth,
+    texH: glyph.texHeight,
+    xOffset: zigzag(glyph.xOffset),
+    yOffset: zigzag(glyph.yOffset),
+    width: glyph.width,
+    height: glyph.height,
+    advanceWidth: zigzag(glyph.advanceWidth),
+    channels: texels > 0 ? glyph.bitmap.length / texels : 4,
+    data: Buffer.from(glyph.bitmap)
+  })
+}
+
+function readGlyphField (tag: number, glyph: RangeGlyph, pbf: Pbf): void {
+  if (tag === 1) glyph.id = pbf.readVarint()
+  else if (tag === 2) glyph.bitmap = pbf.readBytes()
+  else if (tag === 3) glyph.texWidth = pbf.readVarint()
+  else if (tag === 4) glyph.texHeight = pbf.readVarint()
+  else if (tag === 5) glyph.xOffset = pbf.readSVarint()
+  else if (tag === 6) glyph.yOffset = pbf.readSVarint()
+  else if (tag === 7) glyph.advanceWidth = pbf.readVarint()
+  else if (tag === 8) glyph.width = pbf.readVarint()
+  else if (tag === 9) glyph.height = pbf.readVarint()
+  else if (tag === 10) glyph.code = pbf.readString()
+}
@@ -0,0 +1,125 @@
+import fs from 'fs'
+import path from 'path'
+import sharp from 'sharp'
+import { ATLAS_PLACEMENT_SIZE, packAtlas } from '../binding'
+import { buildMetadata } from './sql'
+
+import type { Glyph, GlyphMap } from '../process/index'
+
+export interface SpriteSheetOptions {
+  /** Type of storage */
+  storeType: 'SPRITESHEET'
+  /** folder to write into; each map gets a folder of its own named after it */
+  out: string
+  /** width and height of every page in pixels. Default is 2048 */
+  pageSize?: number
+  /** pixels kept free between glyphs so sampling doesn't bleed into a neighbour. Default is 1 */
+  padding?: number
+}
+
+/** where a glyph sits in the sprite sheet, with the metrics of its stored header */
+export interface SpriteGlyph {
+  /** page the glyph is on */
+  page: number
+  /** left of the glyph on its page */
+  x: number
+  /** top of the glyph on its page */
+  y: number
+  /** texture width */
+  texW: number
+  /** texture height */
+  texH: number
+  xOffset: number
+  yOffset: number
+  /** glyph width in extent units */
+  width: number
+  /** glyph height in extent units */
+  height: number
+  advanceWidth: number
+}
+
+export interface SpriteSheetIndex {
+  pageWidth: number
+  pageHeight: number
+  /** channels per pixel of every page */
+  channels: number
+  /** number of pages, stored as <page>.png */
+  pages: number
+  /** glyph id => placement */
+  glyphs: Record<string, SpriteGlyph>
+  /** unicode => unicode whose placement it shares */
+  aliases: Record<string, number>
+}
+
+// SPRITE SHEET
+// <out>/<name>/<page>.png for every page, <out>/<name>/index.json (SpriteSheetIndex) and
+// <out>/<name>/metadata, the `buildMetadata` blob
+
+/** Pack every glyph of the map onto atlas pages and write the pages and their index */
+export async function storeGlyphsToSpriteSheet (
+  name: string,
+  map: GlyphMap,
+  options: SpriteSheetOptions
+): Promise<void> {
+  const { pageSize = 2048, padding = 1 } = options
+  const channels = map.channels ?? 4
+  const folder = path.join(options.out, name)
+  await fs.promises.mkdir(folder, { recursive: true })
+
+  const glyphs = map.glyphs.filter((glyph) => !glyph.dead && glyph.glyphBuffer.length > 0)
+  const widths = new Uint32Array(glyphs.map((glyph) => glyph.texWidth))
+  const heights = new Uint32Array(glyphs.map((glyph) => glyph.texHeight))
+  const { placements, pages } = packAtlas(widths, heights, pageSize, pageSize, padding)
+
+  const pageData = Array.from({ length: pages }, () => Buffer.alloc(pageSize * pageSize * channels))
+  const index: SpriteSheetIndex = {
+    pageWidth: pageSize,
+    pageHeight: pageSize,
+    channels,
+    pages,
+    glyphs: {},
+    aliases: {}
+  }
+  glyphs.forEach((glyph, i) => {
+    const [page, x, y] = placements.subarray(i * ATLAS_PLACEMENT_SIZE, (i + 1) * ATLAS_PLACEMENT_SIZE)
+    if (page < 0) return
+    copyGlyph(glyph, pageData[page], pageSize, channels, x, y)
+    index.glyphs[glyph.id] = {
+      page,
+      x,
+      y,
+      texW: glyph.texWidth,
+      texH: glyph.texHeight,
+      xOffset: glyph.xOffset,
+      yOffset: glyph.yOffset,
+      width: glyph.width,
+      height: glyph.height,
+      advanceWidth: glyph.advanceWidth
+    }
+  })
+  if ('aliases' in map) {
+    for (const [unicode, target] of map.aliases) {
+      if (String(target) in index.glyphs) index.aliases[unicode] = target
+    }
+  }
+
+  await Promise.all([
+    ...pageData.map(async (data, page) => {
+      await sharp(data, { raw: { width: pageSize, height: pageSize, channels: channels as 1 | 2 | 3 | 4 } })
+        .png()
+        .toFile(path.join(folder, `${page}.png`))
+    }),
+    fs.promises.writeFile(path.join(folder, 'index.json'), JSON.stringify(index)),
+    fs.promises.writeFile(path.join(folder, 'metadata'), buildMetadata(map))
+  ])
+}
+
+/** copy a glyph's pixels (after its 14 byte header) row by row into its place on the page */
+function copyGlyph (glyph: Glyph, page: Buffer, pageWidth: number, channels: number, x: number, y: number): void {
+  const { glyphBuffer, texWidth, texHeight } = glyph
+  const rowLength = texWidth * channels
+  for (let row = 0; row < texHeight; row++) {
+    const start = 14 + row * rowLength
+    glyphBuffer.copy(page, ((y + row) * pageWidth + x) * channels, start, start + rowLength)
+  }
+}
@@ -12,6 +12,11 @@ export interface SQLiteOptions {
   out: string
   /** If true, index the glyph using both the name and id; otherwise only store the id */
   multi?: boolean
+  /**
+   * Compact the database with `finalizeSQL` once the map is stored. Defaults to true when `multi` is
+   * false; databases shared by several maps should call `finalizeSQL` after the last one instead
+   */
+  finalize?: boolean
 }
 
 export type IconMap = Record<string, Array<{ glyphID: number, colorID: number }>>
@@ -36,6 +41,8 @@ export interface ParsedGlyph {
   height: number
   /** how far to move the cursor */
   advanceWidth: number
+  /** channels per pixel in data (1 sdf/psdf, 3 msdf, 4 mtsdf or RGBA) */
+  channels: number
   /** glyph data */
   data: Buffer
 }
@@ -51,8 +58,12 @@ export interface Metadata {
   range: number
   /** the default advance of the glyphs */
   defaultAdvance: number
-  /** Glyph Set - only tracks unicodes though not substitution values */
+  /** channels per pixel of the stored glyphs */
+  channels: number
+  /** Glyph Set - only tracks unicodes though not substitution values. Includes aliases */
   glyphSet: Set<number>
+  /** unicode => unicode whose stored glyph it shares */
+  aliases: Map<number, number>
   /** Store icons { name: { glyphID, colorID }[] } */
   iconMap: IconMap
   /** Store colors name => [r, g, b, a] */
@@ -74,8 +85,8 @@ export interface Metadata {
 // defaultAdvance: 12 (writeUInt16LE)
 // 14 glyphMapSize (writeUInt32LE)
 // 18 image length (writeUInt32LE)
-// 22 colors length (writeUInt32LE)
-// 26 glyph-remap length (writeUInt32LE)
+// 22 channels per pixel (writeUInt8); 0 in older stores means 4 (RGBA)
+// 24 alias count (writeUInt32LE)
 // 30 glyphs (glyphSize: 8 {unicode (2), position (4), length (2)})
 // after glyphs, glyph remap (REMAP)
 
@@ -87,73 +98,261 @@ export interface Metadata {
 // 3: component count (writeUInt8)
 // 4+: [repeating] component unicodes (writeUInt16LE)
 
+// ALIASES (after the substitutes)
+// [repeating] unicode (writeUInt16LE), unicode of the stored glyph (writeUInt16LE)
+
 const schema = fs.readFileSync(path.join(__dirname, '../schema.sql'), 'utf8')
 
+/** `PRAGMA user_version` of databases built with `schema.sql` */
+export const SCHEMA_VERSION = 2
+
+/** a stored blob: a Buffer, or base64 text in version 1 databases */
+type StoredData = Buffer | string
+
 export function storeGlyphsToSQL (
   name: string,
   map: GlyphMap,
   options: SQLiteOptions,
   consoleLog = false
 ): void {
-  const { out, multi } = options
+  const { out, multi, finalize = multi === false } = options
   const serializeName = multi !== false ? name : undefined
 
-  const db = new DatabaseConstructor(out)
-  db.pragma('journal_mode = WAL')
-  db.exec(schema)
-
-  for (const glyph of map.glyphs) {
-    if (glyph.dead) continue
-    const { id, glyphBuffer } = glyph
-    serializeGlyph(db, id, glyphBuffer, serializeName)
-  }
-  serializeMetadata(db, map, multi !== false)
-  db.close()
+  const db = openBuildDatabase(out)
+  const writeGlyph = prepareGlyphWrite(db, serializeName)
+  // one commit for the whole map instead of one per glyph
+  db.transaction(() => {
+    for (const glyph of map.glyphs) {
+      if (glyph.dead) continue
+      const { id, glyphBuffer } = glyph
+      writeGlyph(id, glyphBuffer)
+    }
+    serializeMetadata(db, map, multi !== false)
+  })()
+  closeBuildDatabase(db)
+  if (finalize) finalizeSQL(out)
 }
 
 export function serializeSVGs (name: string, font: GlyphMap, options: SQLiteOptions): void {
-  const { out, multi } = options
-  const serializeName = multi !== false ? name : undefined
+  storeGlyphsToSQL(name, font, options)
+}
 
+/**
+ * Open a database for a bulk build. Durability is traded for speed since an interrupted build is
+ * rerun anyway: no syncs, a 256 MiB page cache and in-memory temp tables.
+ */
+function openBuildDatabase (out: string): Database {
   const db = new DatabaseConstructor(out)
   db.pragma('journal_mode = WAL')
-  db.exec(schema)
+  db.pragma('synchronous = OFF')
+  db.pragma('cache_size = -262144')
+  db.pragma('temp_store = MEMORY')
+  migrateDatabase(db)
+  return db
+}
 
-  for (const glyph of font.glyphs) {
-    if (glyph.dead) continue
-    const { id, glyphBuffer } = glyph
-    serializeGlyph(db, id, glyphBuffer, serializeName)
+/** the tables of `schema.sql` and their keys */
+const TABLE_KEYS: Record<string, string[]> = { glyph: ['code'], glyph_multi: ['name', 'code'], metadata: ['name'] }
+
+/**
+ * the rows of each renamed version 1 table worth keeping. Rows missing their key can't be read
+ * back and are dropped, except metadata without a name, which is the metadata of a single-map
+ * store ('metadata'); a row named so already wins over it
+ */
+const LEGACY_ROWS: Record<string, string> = {
+  glyph: 'SELECT code, legacy_blob(data) FROM glyph_v1 WHERE code IS NOT NULL AND data IS NOT NULL',
+  glyph_multi: 'SELECT name, code, legacy_blob(data) FROM glyph_multi_v1 WHERE name IS NOT NULL AND code IS NOT NULL AND data IS NOT NULL',
+  metadata: "SELECT coalesce(name, 'metadata'), legacy_blob(data) FROM metadata_v1 WHERE data IS NOT NULL ORDER BY name IS NULL"
+}
+
+/** `schema.sql` without its own BEGIN/COMMIT, to run inside a migration's transaction */
+const schemaStatements = schema.replace(/^(BEGIN|COMMIT);$/gm, '')
+
+/**
+ * Create the tables, moving a version 1 database's base64 rows into them as blobs. The old
+ * tables are renamed out of the way first so the new ones can take their names; renaming,
+ * creating and copying share one transaction, so a failed migration leaves the database as it was
+ */
+export function migrateDatabase (db: Database): void {
+  const version = db.pragma('user_version', { simple: true }) as number
+  if (version >= SCHEMA_VERSION) {
+    db.exec(schema)
+    return
   }
-  serializeMetadata(db, font, multi !== false)
+  const legacy = (db.prepare("SELECT name FROM sqlite_master WHERE type = 'table'").all() as Array<{ name: string }>)
+    .map(({ name }) => name)
+    .filter((name) => name in TABLE_KEYS)
+  // the rows are copied by SQLite itself, decoding the base64 text on the way
+  db.function('legacy_blob', { deterministic: true }, (data: unknown) => toBuffer(data as StoredData))
+  db.transaction(() => {
+    if (legacy.length > 0) db.exec('DROP VIEW IF EXISTS glyphs; DROP VIEW IF EXISTS glyphs_multi;')
+    for (const table of legacy) db.exec(`ALTER TABLE ${table} RENAME TO ${table}_v1`)
+    db.exec(schemaStatements)
+    for (const table of legacy) {
+      db.exec(`INSERT OR IGNORE INTO ${table} (${[...TABLE_KEYS[table], 'data'].join(', ')}) ${LEGACY_ROWS[table]}`)
+      db.exec(`DROP TABLE ${table}_v1`)
+    }
+    db.pragma(`user_version = ${SCHEMA_VERSION}`)
+  })()
+}
+
+/** fold the WAL back into the database so it stands alone once closed */
+function closeBuildDatabase (db: Database): void {
+  db.pragma('wal_checkpoint(TRUNCATE)')
   db.close()
 }
 
-export function serializeGlyph (db: Database, code: string, dataBuffer: Buffer, name?: string): void {
-  const data = bufferToBase64(dataBuffer)
+/**
+ * Compact a finished database and refresh its planner statistics. Both rewrite the whole file, so
+ * run this once after the last map is stored rather than after every font of a shared database
+ */
+export function finalizeSQL (out: string): void {
+  const db = new DatabaseConstructor(out)
+  db.exec('VACUUM')
+  db.exec('ANALYZE')
+  closeBuildDatabase(db)
+}
+
+/** `serializeGlyph` with its statement prepared once, for writing many glyphs */
+function prepareGlyphWrite (db: Database, name?: string): (code: string, dataBuffer: Buffer) => void {
   //  Write to SQL ask key->unicode and value->glyphBuffer and if multi name->name
   if (name !== undefined) { // this means we want to store to glyph_multi
-    const writeGlyph = db.prepare<{ name: string, code: string, data: string }>('REPLACE INTO glyph_multi (name, code, data) VALUES (@name, @code, @data)')
-    writeGlyph.run({ name, code, data })
-  } else {
-    const writeGlyph = db.prepare<{ code: string, data: string }>('REPLACE INTO glyph (code, data) VALUES (@code, @data)')
-    writeGlyph.run({ code, data })
+    const writeGlyph = db.prepare<{ name: string, code: string, data: Buffer }>('REPLACE INTO glyph_multi (name, code, data) VALUES (@name, @code, @data)')
+    return (code, data) => { writeGlyph.run({ name, code, data }) }
   }
+  const writeGlyph = db.prepare<{ code: string, data: Buffer }>('REPLACE INTO glyph (code, data) VALUES (@code, @data)')
+  return (code, data) => { writeGlyph.run({ code, data }) }
 }
 
+export function serializeGlyph (db: Database, code: string, dataBuffer: Buffer, name?: string): void {
+  prepareGlyphWrite(db, name)(code, dataBuffer)
+}
+
+/** glyph blobs packed back to back: blob `i` is `data.subarray(offsets[i], offsets[i + 1])` */
+export interface GlyphPack {
+  /** the codes found, in the order requested */
+  codes: string[]
+  /** codes.length + 1 offsets into data */
+  offsets: Uint32Array
+  /** header + pixels of every glyph found */
+  data: Buffer
+}
+
+/** codes per Mapbox-style glyph range (0-255, 256-511, ...) */
+export const GLYPH_RANGE_SIZE = 256
+
+/**
+ * Fetch a set of glyphs with one statement and pack them into one buffer, so a label's glyphs can
+ * be answered with a single query and copy. Aliased unicodes are packed with a copy of the glyph
+ * they share (see `aliasGlyphBuffer`); codes not stored are skipped
+ */
+export function getGlyphs (db: Database, codes: string[], name?: string): GlyphPack {
+  // aliases have no row of their own, so ask for the glyph they share and file it under the alias
+  const aliases = getAliases(db, name)
+  const stored = codes.map((code) => {
+    const target = /^\d+$/.test(code) ? aliases.get(Number(code)) : undefined
+    return target === undefined ? code : String(target)
+  })
+  const rows = selectGlyphs(db, [...new Set(stored)], name)
+  const found = new Map<string, Buffer>()
+  codes.forEach((code, i) => {
+    const blob = rows.get(stored[i])
+    if (blob === undefined) return
+    found.set(code, stored[i] === code ? blob : aliasGlyphBuffer(Number(code), blob))
+  })
+
+  const packed: string[] = []
+  const blobs: Buffer[] = []
+  const offsets = new Uint32Array(found.size + 1)
+  for (const code of codes) {
+    const blob = found.get(code)
+    if (blob === undefined) continue
+    found.delete(code) // a code requested twice is packed once
+    offsets[packed.length + 1] = offsets[packed.length] + blob.length
+    packed.push(code)
+    blobs.push(blob)
+  }
+  return { codes: packed, offsets, data: Buffer.concat(blobs, offsets[packed.length]) }
+}
+
+/** `getGlyphs` for the unicodes `start` to `end` inclusive; defaults to the range containing `start` */
+export function getGlyphRange (
+  db: Database,
+  start: number,
+  end = start - (start % GLYPH_RANGE_SIZE) + GLYPH_RANGE_SIZE - 1,
+  name?: string
+): GlyphPack {
+  const codes: string[] = []
+  for (let unicode = start; unicode <= end; unicode++) codes.push(String(unicode))
+  return getGlyphs(db, codes, name)
+}
+
+/**
+ * The blob of a glyph. Aliases have no row of their own, so a unicode that isn't stored is looked
+ * up in the metadata's alias table and answered with a copy of the glyph it shares
+ */
 export function getGlyph (db: Database, code: string, name?: string): undefined | Buffer {
-  let base64: string | undefined
+  const data = selectGlyph(db, code, name)
+  if (data !== undefined) return data
+  if (!/^\d+$/.test(code)) return undefined
+  const target = getAliases(db, name).get(Number(code))
+  if (target === undefined) return undefined
+  const shared = selectGlyph(db, String(target), name)
+  return shared === undefined ? undefined : aliasGlyphBuffer(Number(code), shared)
+}
+
+/** A copy of the blob of the glyph an alias shares, with the alias's unicode in its header */
+export function aliasGlyphBuffer (unicode: number, data: Buffer): Buffer {
+  const alias = Buffer.from(data)
+  alias.writeUInt16LE(unicode, 0)
+  return alias
+}
+
+/** code => blob of the stored glyphs among `codes` */
+function selectGlyphs (db: Database, codes: string[], name?: string): Map<string, Buffer> {
+  // the codes travel as one JSON parameter, so the statement is the same for any number of them
+  const list = JSON.stringify(codes)
+  const rows = (
+    name === undefined
+      ? db.prepare<[string]>('SELECT code, data FROM glyph WHERE code IN (SELECT value FROM json_each(?))').all(list)
+      : db.prepare<[string, string]>('SELECT code, data FROM glyph_multi WHERE name = ? AND code IN (SELECT value FROM json_each(?))').all(name, list)
+  ) as Array<{ code: string, data: StoredData | null }>
+  const found = new Map<string, Buffer>()
+  for (const { code, data } of rows) if (data !== null) found.set(code, toBuffer(data))
+  return found
+}
+
+function selectGlyph (db: Database, code: string, name?: string): undefined | Buffer {
+  let data: StoredData | undefined
   if (name !== undefined) { // this means we want to store to glyph_multi
     const getGlyph = db.prepare<{ code: string, name: string }>('SELECT data FROM glyph_multi WHERE name = @name AND code = @code')
-    const res = getGlyph.get({ code, name }) as { data: string | undefined } | undefined
-    base64 = res?.data
+    const res = getGlyph.get({ code, name }) as { data: StoredData | undefined } | undefined
+    data = res?.data
   } else {
     const getGlyph = db.prepare('SELECT data FROM glyph WHERE code = @code')
-    const res = getGlyph.get({ code }) as { data: string | undefined } | undefined
-    base64 = res?.data
+    const res = getGlyph.get({ code }) as { data: StoredData | undefined } | undefined
+    data = res?.data
   }
-  if (base64 === undefined) return undefined
-  const buffer = base64ToBuffer(base64)
-  return buffer
+  if (data === undefined || data === null) return undefined
+  return toBuffer(data)
+}
+
+/**
+ * unicode => stored unicode of a map's aliases, read straight from the tail of its metadata blob
+ * (see ALIASES) without parsing the rest
+ */
+export function getAliases (db: Database, name = 'metadata'): Map<number, number> {
+  const aliases = new Map<number, number>()
+  const getMetadata = db.prepare('SELECT data FROM metadata WHERE name = @name')
+  const res = getMetadata.get({ name }) as { data: StoredData | null } | undefined
+  if (res === undefined || res.data === null) return aliases
+  const data = toBuffer(res.data)
+  if (data.length < 30) return aliases
+  const aliasCount = data.readUInt32LE(24)
+  for (let pos = data.length - aliasCount * 4; pos < data.length; pos += 4) {
+    aliases.set(data.readUInt16LE(pos), data.readUInt16LE(pos + 2))
+  }
+  return aliases
 }
 
 // FONT METADATA:
@@ -161,113 +360,136 @@ export function getGlyph (db: Database, code: string, name?: string): undefined
 // metadata: size, maxHeight (largest height value), range, scale, name,
 // extent, glyphs
 export function serializeMetadata (db: Database, map: GlyphMap, multi: boolean): void {
-  const { name, extent, size, maxHeight, range, glyphs, defaultAdvance } = map
+  const data = buildMetadata(map)
 
-  // build the glyph map
-  const aliveGlyphs = glyphs.filter(g => !g.dead && g.type === 'unicode')
-  const glyphCount = aliveGlyphs.length
-  const glyphMap = Buffer.alloc(2 * glyphCount)
-  let pos = 0
-  for (const glyph of aliveGlyphs) {
-    if (!('unicode' in glyph)) continue
-    glyphMap.writeUInt16LE(glyph.unicode, pos)
-    pos += 2
-  }
+  // Store metadata in sqlite database
+  const writeMetadata = db.prepare('REPLACE INTO metadata (name, data) VALUES (@name, @data)')
+  writeMetadata.run({ name: multi ? map.name : 'metadata', data })
+}
 
-  // build the substitute metadata buffer
-  // 0: substitute type (writeUInt8) [4]
-  // 1: component count (writeUInt8)
-  // 2+: [repeating] component unicodes (writeUInt16LE)
-  let subsBuf = Buffer.alloc(0)
+/**
+ * the metadata blob `parseMetadata` reads, whatever store it ends up in. Every section is sized
+ * first and then written straight into one buffer, so the cost is linear in the glyphs,
+ * substitutes and icons (fonts with thousands of ligatures included)
+ */
+export function buildMetadata (map: GlyphMap): Buffer {
+  const { extent, size, maxHeight, range, glyphs, defaultAdvance } = map
+
+  // PASS 1: size every section
+  // glyph map: the alive unicodes
+  const aliveUnicodes: number[] = []
+  for (const glyph of glyphs) if (!glyph.dead && glyph.type === 'unicode') aliveUnicodes.push(glyph.unicode)
+  const glyphCount = aliveUnicodes.length
+  // aliases, dropping those whose stored glyph didn't survive conversion
+  const aliveSet = new Set(aliveUnicodes)
+  const aliases = 'aliases' in map ? [...map.aliases].filter(([, target]) => aliveSet.has(target)) : []
+  // iconMap: nameLength, mapLength, name, [glyphID, colorID]
+  let iconMapLength = 0
+  if ('paths' in map) {
+    for (const [name, iconMap] of map.paths) iconMapLength += 2 + name.length + iconMap.length * 4
+  }
+  // colors: [r, g, b, a]
+  const colorLength = 'colors' in map ? map.colors.length * 4 : 0
+  // substitutes: type and count are 8bits, the components 16bits
+  let subsLength = 0
   if ('substitutes' in map) {
-    for (const { code } of map.substitutes) {
-      const [type, count, ...codes] = code
-      // the first two numbers are 8bits, the rest are 16bits
-      const length = (code.length - 2) * 2 + 2
-      const buf = Buffer.alloc(length)
-      buf.writeUInt8(type, 0)
-      buf.writeUInt8(count, 1)
-      for (let i = 0; i < codes.length; i++) {
-        buf.writeUInt16LE(codes[i], i * 2 + 2)
-      }
-      subsBuf = Buffer.concat([subsBuf, buf])
-    }
+    for (const { code } of map.substitutes) subsLength += (code.length - 2) * 2 + 2
   }
 
+  const glyphMapStart = 30
+  const iconMapStart = glyphMapStart + glyphCount * 2
+  const colorStart = iconMapStart + iconMapLength
+  const subsStart = colorStart + colorLength
+  const aliasStart = subsStart + subsLength
+  const meta = Buffer.alloc(aliasStart + aliases.length * 4)
+
+  // PASS 2: write
+  // build the metadata
+  meta.writeUInt16LE(extent, 0)
+  meta.writeUInt16LE(size, 2)
+  meta.writeUInt16LE(maxHeight, 4)
+  meta.writeUInt16LE(range, 6)
+  meta.writeUInt16LE(defaultAdvance, 8)
+  meta.writeUInt16LE(glyphCount, 10)
+  meta.writeUInt32LE(iconMapLength, 12) // iconMapCount (unused in fonts)
+  meta.writeUInt16LE(colorLength / 4, 16) // colorCount (unused in fonts)
+  meta.writeUint32LE(subsLength, 18) // substituteCount
+  meta.writeUInt8(map.channels ?? 4, 22) // channels per pixel
+  meta.writeUInt32LE(aliases.length, 24) // aliasCount
+
+  // build the glyph map
+  let pos = glyphMapStart
+  for (const unicode of aliveUnicodes) pos = meta.writeUInt16LE(unicode, pos)
+
   // store iconMap
-  // nameLength, mapLength, name, [glyphID, colorID]
   // [glyphCount (uint8), glyphID (uint16), colorID (uint16), glyphID (uint16), colorID (uint16), ...]
-  const iconMapBufs = []
   if ('paths' in map) {
     for (const [name, iconMap] of map.paths) { // { glyphID, colorID }
-      const buf = Buffer.alloc(name.length + iconMap.length * 4 + 2)
-      buf[0] = name.length
-      buf[1] = iconMap.length
+      meta[pos] = name.length
+      meta[pos + 1] = iconMap.length
+      pos += 2
       // store name
-      for (let i = 0; i < name.length; i++) buf.writeUInt8(name.charCodeAt(i), i + 2)
+      for (let i = 0; i < name.length; i++) pos = meta.writeUInt8(name.charCodeAt(i), pos)
       // store positional data
-      for (let i = 0; i < iconMap.length; i++) {
-        const { glyphID, colorID } = iconMap[i]
-        const pos = name.length + (i * 4) + 2
-        buf.writeUInt16LE(glyphID, pos)
-        buf.writeUInt16LE(colorID, pos + 2)
+      for (const { glyphID, colorID } of iconMap) {
+        pos = meta.writeUInt16LE(glyphID, pos)
+        pos = meta.writeUInt16LE(colorID, pos)
       }
-      iconMapBufs.push(buf)
     }
   }
-  const iconMapBuf = Buffer.concat(iconMapBufs)
 
   // store colors
   // [r (uint8), g (uint8), b (uint8), a (uint8), ...]
-  let colorLength = 0
-  let colorBuf = Buffer.alloc(0)
   if ('colors' in map) {
-    const colorList = Buffer.from(map.colors.flatMap(color => [color.r, color.g, color.b, color.a]))
-    colorLength = colorList.length
-    colorBuf = Buffer.alloc(colorLength)
-    for (let i = 0; i < colorLength; i++) colorBuf.writeUInt8(colorList[i], i)
+    for (const { r, g, b, a } of map.colors) {
+      meta[pos++] = r
+      meta[pos++] = g
+      meta[pos++] = b
+      meta[pos++] = a
+    }
   }
 
-  // build the metadata
-  const meta = Buffer.alloc(30)
-  meta.writeUInt16LE(extent, 0)
-  meta.writeUInt16LE(size, 2)
-  meta.writeUInt16LE(maxHeight, 4)
-  meta.writeUInt16LE(range, 6)
-  meta.writeUInt16LE(defaultAdvance, 8)
-  meta.writeUInt16LE(glyphCount, 10)
-  meta.writeUInt32LE(iconMapBuf.length, 12) // iconMapCount (unused in fonts)
-  meta.writeUInt16LE(colorLength / 4, 16) // colorCount (unused in fonts)
-  meta.writeUint32LE(subsBuf.length, 18) // substituteCount
-  const metaBuffer = Buffer.concat([meta, glyphMap, iconMapBuf, colorBuf, subsBuf])
-  const data = bufferToBase64(metaBuffer)
+  // build the substitute metadata
+  // 0: substitute type (writeUInt8) [4]
+  // 1: component count (writeUInt8)
+  // 2+: [repeating] component unicodes (writeUInt16LE)
+  if ('substitutes' in map) {
+    for (const { code } of map.substitutes) {
+      pos = meta.writeUInt8(code[0], pos)
+      pos = meta.writeUInt8(code[1], pos)
+      for (let i = 2; i < code.length; i++) pos = meta.writeUInt16LE(code[i], pos)
+    }
+  }
 
-  // Store metadata in sqlite database
-  const writeMetadata = db.prepare('REPLACE INTO metadata (name, data) VALUES (@name, @data)')
-  writeMetadata.run({ name: multi ? name : 'metadata', data })
+  // build the aliases
+  for (const [unicode, target] of aliases) {
+    pos = meta.writeUInt16LE(unicode, pos)
+    pos = meta.writeUInt16LE(target, pos)
+  }
+
+  return meta
 }
 
 export function getMetadata (db: Database, name = 'metadata'): undefined | Metadata {
   const getMetadata = db.prepare('SELECT data FROM metadata WHERE name = @name')
-  const res = getMetadata.get({ name }) as { data: string | undefined } | undefined
+  const res = getMetadata.get({ name }) as { data: StoredData | undefined } | undefined
   const data = res?.data
   if (data === undefined) return undefined
-  const buffer = base64ToBuffer(data)
-  return parseMetadata(buffer)
+  return parseMetadata(toBuffer(data))
 }
 
 export function parseGlyphs (db: Database, name?: string): ParsedGlyph[] {
   const glyphs: ParsedGlyph[] = []
   const glyphBuffers = (
     name === undefined
-      ? db.prepare('SELECT data AND code FROM glyph').all()
-      : db.prepare<{ name: string }>('SELECT data AND code FROM glyph_multi WHERE name = @name').all({ name })
-  ) as unknown as Array<{ data: Buffer, code: string } | undefined>
+      ? db.prepare('SELECT code, data FROM glyph').all()
+      : db.prepare<{ name: string }>('SELECT code, data FROM glyph_multi WHERE name = @name').all({ name })
+  ) as unknown as Array<{ data: StoredData, code: string } | undefined>
   if (glyphBuffers === undefined) throw new Error('Glyphs not found')
   for (const gBuffer of glyphBuffers) {
     if (gBuffer === undefined) continue
     const { data, code } = gBuffer
-    const glyph = parseGlyphBuffer(code, data)
+    const glyph = parseGlyphBuffer(code, toBuffer(data))
     glyphs.push(glyph)
   }
   return glyphs
@@ -293,6 +515,9 @@ export function parseGlyphBuffer (code: string, data: Buffer): ParsedGlyph {
   const yOffset = dv.getUint16(10, true)
   const advanceWidth = dv.getUint16(12, true)
   const glyphBuffer = Buffer.from(data.subarray(14))
+  // the header has no room for it, so the channel count follows from the payload size
+  const texels = texWidth * texHeight
+  const channels = texels > 0 ? glyphBuffer.length / texels : 4
   return {
     code,
     unicode,
@@ -303,6 +528,7 @@ export function parseGlyphBuffer (code: string, data: Buffer): ParsedGlyph {
     width,
     height,
     advanceWidth,
+    channels,
     data: glyphBuffer
   }
 }
@@ -319,7 +545,9 @@ export function parseMetadata (data: Buffer): Metadata {
   const glyphCount = meta.getUint16(10, true)
   const iconMapSize = meta.getUint32(12, true)
   const colorBufSize = meta.getUint16(16, true) * 4
-  const substituteSize = meta.getUint16(18, true)
+  const substituteSize = meta.getUint32(18, true)
+  const channels = meta.getUint8(22) === 0 ? 4 : meta.getUint8(22)
+  const aliasCount = meta.getUint32(24, true)
 
   // store glyphSet
   const glyphSet = new Set<number>()
@@ -334,7 +562,9 @@ export function parseMetadata (data: Buffer): Metadata {
     maxHeight,
     range,
     defaultAdvance,
+    channels,
     glyphSet,
+    aliases: new Map<number, number>(),
     iconMap: {},
     colors: [],
     substitutes: []
@@ -343,6 +573,13 @@ export function parseMetadata (data: Buffer): Metadata {
   metadata.iconMap = buildIconMap(iconMapSize, new DataView(inputBuffer, glyphEnd, iconMapSize))
   metadata.colors = buildColorMap(colorBufSize, new DataView(inputBuffer, glyphEnd + iconMapSize, colorBufSize))
   metadata.substitutes = buildSubstitutes(substituteSize, new DataView(inputBuffer, glyphEnd + iconMapSize + colorBufSize))
+  // the aliases close the buffer
+  const aliasStart = data.byteLength - aliasCount * 4
+  for (let i = 0; i < aliasCount; i++) {
+    const unicode = meta.getUint16(aliasStart + i * 4, true)
+    metadata.aliases.set(unicode, meta.getUint16(aliasStart + i * 4 + 2, true))
+    glyphSet.add(unicode)
+  }
 
   return metadata
 }
@@ -405,11 +642,7 @@ function buildSubstitutes (substituteSize: number, dv: DataView): SubstitutePars
   return substitutes
 }
 
-// create a function that converts a Uint8Array to a base64 string
-function bufferToBase64 (buffer: Buffer): string {
-  return buffer.toString('base64')
-}
-
-function base64ToBuffer (base64: string): Buffer {
-  return Buffer.from(base64, 'base64')
+/** blobs come back as they are; version 1 databases stored them as base64 text */
+function toBuffer (data: StoredData): Buffer {
+  return typeof data === 'string' ? Buffer.from(data, 'base64') : data
 }
@@ -0,0 +1,20 @@
+// the parts of pbf 3 the range files use; the package ships no types
+declare module 'pbf' {
+  class Pbf {
+    constructor (buf?: Uint8Array)
+    pos: number
+    readFields<T>(readField: (tag: number, result: T, pbf: Pbf) => void, result: T, end?: number): T
+    readMessage<T>(readField: (tag: number, result: T, pbf: Pbf) => void, result: T): T
+    readVarint (): number
+    readSVarint (): number
+    readString (): string
+    readBytes (): Uint8Array
+    writeMessage<T>(tag: number, fn: (obj: T, pbf: Pbf) => void, obj: T): void
+    writeVarintField (tag: number, val: number): void
+    writeSVarintField (tag: number, val: number): void
+    writeStringField (tag: number, str: string): void
+    writeBytesField (tag: number, buffer: Uint8Array): void
+    finish (): Uint8Array
+  }
+  export = Pbf
+}
@@ -0,0 +1,101 @@
+#include "atlas_packer.h"
+
+#include <algorithm>
+#include <climits>
+#include <numeric>
+
+AtlasPacker::AtlasPacker(int pageWidth, int pageHeight, int padding)
+  : pageWidth(pageWidth), pageHeight(pageHeight), padding(padding) {}
+
+int AtlasPacker::pack(const uint32_t *widths, const uint32_t *heights, size_t count, int32_t *placements) {
+  pages.clear();
+  // tallest first, then widest, so every row of the skyline is filled by similar rectangles
+  std::vector<size_t> order(count);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    if (heights[a] != heights[b]) return heights[a] > heights[b];
+    return widths[a] > widths[b];
+  });
+
+  for (size_t i : order) {
+    int32_t *placement = placements + 3 * i;
+    int width = (int) widths[i] + padding;
+    int height = (int) heights[i] + padding;
+    placement[0] = -1;
+    placement[1] = 0;
+    placement[2] = 0;
+    if (widths[i] == 0 || heights[i] == 0) continue;
+    if ((int) widths[i] > pageWidth || (int) heights[i] > pageHeight) continue;
+    // the padding only separates neighbours, so a rectangle may touch the page's far edges
+    int fitWidth = std::min(width, pageWidth);
+    int fitHeight = std::min(height, pageHeight);
+
+    size_t segment = 0;
+    int y = 0;
+    size_t page = 0;
+    while (page < pages.size() && !findPosition(pages[page], fitWidth, fitHeight, segment, y)) page++;
+    if (page == pages.size()) {
+      pages.push_back(Skyline(1, Segment{0, 0, pageWidth}));
+      findPosition(pages[page], fitWidth, fitHeight, segment, y);
+    }
+    placement[0] = (int32_t) page;
+    placement[1] = pages[page][segment].x;
+    placement[2] = y;
+    place(pages[page], segment, fitWidth, y + fitHeight);
+  }
+
+  return (int) pages.size();
+}
+
+bool AtlasPacker::findPosition(const Skyline &skyline, int width, int height, size_t &segment, int &y) const {
+  int bestTop = INT_MAX;
+  int bestWidth = INT_MAX;
+  for (size_t i = 0; i < skyline.size(); i++) {
+    int x = skyline[i].x;
+    if (x + width > pageWidth) break;
+    // the rectangle rests on the highest segment it spans
+    int base = 0;
+    int remaining = width;
+    for (size_t j = i; remaining > 0; j++) {
+      base = std::max(base, skyline[j].y);
+      remaining -= skyline[j].width;
+    }
+    int top = base + height;
+    if (top > pageHeight) continue;
+    // lowest top edge first, then the narrowest segment to waste the least of it
+    if (top < bestTop || (top == bestTop && skyline[i].width < bestWidth)) {
+      bestTop = top;
+      bestWidth = skyline[i].width;
+      segment = i;
+      y = base;
+    }
+  }
+  return bestTop != INT_MAX;
+}
+
+void AtlasPacker::place(Skyline &skyline, size_t segment, int width, int top) {
+  int x = skyline[segment].x;
+  skyline.insert(skyline.begin() + segment, Segment{x, top, width});
+  // trim or drop the segments the new one covers
+  size_t next = segment + 1;
+  while (next < skyline.size()) {
+    Segment &covered = skyline[next];
+    int overlap = x + width - covered.x;
+    if (overlap <= 0) break;
+    if (overlap < covered.width) {
+      covered.x += overlap;
+      covered.width -= overlap;
+      break;
+    }
+    skyline.erase(skyline.begin() + next);
+  }
+  // merge neighbours at the same height
+  for (size_t i = segment > 0 ? segment - 1 : 0; i + 1 < skyline.size() && i <= segment + 1;) {
+    if (skyline[i].y == skyline[i + 1].y) {
+      skyline[i].width += skyline[i + 1].width;
+      skyline.erase(skyline.begin() + i + 1);
+    } else {
+      i++;
+    }
+  }
+}
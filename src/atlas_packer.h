@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Lays rectangles out on fixed size atlas pages with the skyline bottom-left heuristic: each page
+ * keeps the outline of its filled area as a list of horizontal segments, and a rectangle goes
+ * where its top edge ends up lowest. Rectangles are placed tallest first, each on the first open
+ * page it fits, which keeps the skyline flat and the work per rectangle proportional to the
+ * number of segments (a few dozen on a page of glyphs).
+ */
+class AtlasPacker {
+
+public:
+  AtlasPacker(int pageWidth, int pageHeight, int padding);
+
+  /**
+   * Place count rectangles of widths[i] x heights[i] pixels (plus padding on the right and
+   * bottom), writing page, x, y of rectangle i to placements[3 * i]. Empty rectangles and those
+   * larger than a page get page -1. Returns the number of pages used.
+   */
+  int pack(const uint32_t *widths, const uint32_t *heights, size_t count, int32_t *placements);
+
+private:
+  struct Segment {
+    int x, y, width;
+  };
+  typedef std::vector<Segment> Skyline;
+
+  int pageWidth;
+  int pageHeight;
+  int padding;
+  std::vector<Skyline> pages;
+
+  /// Lowest y at which a width x height rectangle fits on the page, with the segment it starts at; false if it doesn't fit
+  bool findPosition(const Skyline &skyline, int width, int height, size_t &segment, int &y) const;
+  /// Raise the skyline under a rectangle placed at segment
+  void place(Skyline &skyline, size_t segment, int width, int top);
+
+};
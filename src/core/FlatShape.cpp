@@ -0,0 +1,81 @@
+
+#include "FlatShape.h"
+
+namespace msdfgen {
+
+FlatShape::FlatShape() { }
+
+FlatShape::FlatShape(const Shape &shape, bool quadraticSearchHints) {
+    build(shape, quadraticSearchHints);
+}
+
+void FlatShape::build(const Shape &shape, bool quadraticSearchHints) {
+    edges.clear();
+    linearSegments.clear();
+    quadraticSegments.clear();
+    cubicSegments.clear();
+    otherSegments.clear();
+    quadraticHints.clear();
+
+    // Reserve exactly so that pointers into the segment arrays stay valid while they fill up
+    size_t counts[4] = { };
+    for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour)
+        for (std::vector<EdgeHolder>::const_iterator edge = contour->edges.begin(); edge != contour->edges.end(); ++edge) {
+            int type = (*edge)->type();
+            ++counts[type >= LinearSegment::EDGE_TYPE && type <= CubicSegment::EDGE_TYPE ? type : 0];
+        }
+    linearSegments.reserve(counts[LinearSegment::EDGE_TYPE]);
+    quadraticSegments.reserve(counts[QuadraticSegment::EDGE_TYPE]);
+    cubicSegments.reserve(counts[CubicSegment::EDGE_TYPE]);
+    otherSegments.reserve(counts[0]);
+    if (quadraticSearchHints)
+        quadraticHints.resize(counts[QuadraticSegment::EDGE_TYPE]);
+    edges.reserve(shape.edgeCount());
+
+    for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour) {
+        if (contour->edges.empty())
+            continue;
+        const EdgeSegment *prevEdge = contour->edges.size() >= 2 ? *(contour->edges.end()-2) : *contour->edges.begin();
+        const EdgeSegment *curEdge = contour->edges.back();
+        for (std::vector<EdgeHolder>::const_iterator nextEdge = contour->edges.begin(); nextEdge != contour->edges.end(); ++nextEdge) {
+            Edge edge;
+            edge.type = curEdge->type();
+            edge.color = curEdge->color;
+            edge.contour = int(contour-shape.contours.begin());
+            edge.quadraticSearchHint = NULL;
+            switch (edge.type) {
+                case LinearSegment::EDGE_TYPE:
+                    linearSegments.push_back(*static_cast<const LinearSegment *>(curEdge));
+                    edge.segment = &linearSegments.back();
+                    break;
+                case QuadraticSegment::EDGE_TYPE:
+                    quadraticSegments.push_back(*static_cast<const QuadraticSegment *>(curEdge));
+                    edge.segment = &quadraticSegments.back();
+                    if (quadraticSearchHints) {
+                        QuadraticSearchHint *hint = &quadraticHints[quadraticSegments.size()-1];
+                        quadraticSegments.back().searchHint(*hint);
+                        edge.quadraticSearchHint = hint;
+                    }
+                    break;
+                case CubicSegment::EDGE_TYPE:
+                    cubicSegments.push_back(*static_cast<const CubicSegment *>(curEdge));
+                    edge.segment = &cubicSegments.back();
+                    break;
+                default:
+                    otherSegments.push_back(EdgeHolder(curEdge->clone()));
+                    edge.segment = otherSegments.back();
+            }
+            edge.start = curEdge->point(0);
+            edge.end = curEdge->point(1);
+            edge.startDirection = curEdge->direction(0).normalize(true);
+            edge.endDirection = curEdge->direction(1).normalize(true);
+            edge.startCorner = (prevEdge->direction(1).normalize(true)+edge.startDirection).normalize(true);
+            edge.endCorner = (edge.endDirection+(*nextEdge)->direction(0).normalize(true)).normalize(true);
+            edges.push_back(edge);
+            prevEdge = curEdge;
+            curEdge = *nextEdge;
+        }
+    }
+}
+
+}
@@ -0,0 +1,77 @@
+
+#pragma once
+
+#include <vector>
+#include "Vector2.hpp"
+#include "SignedDistance.hpp"
+#include "edge-segments.h"
+#include "Shape.h"
+
+namespace msdfgen {
+
+/// A compact copy of a Shape's edges for distance queries. The segments are stored by value in one array per type, and each edge
+/// carries the endpoint data the edge selectors would otherwise recompute for every query, so that queries dispatch by a type tag
+/// instead of chasing pointers and making virtual calls. Must be rebuilt if the shape changes (normalize and color it first).
+class FlatShape {
+
+public:
+    /// An edge in the order ShapeDistanceFinder visits the shape.
+    struct Edge {
+        int type;
+        EdgeColor color;
+        int contour;
+        /// The segment within the flat shape's own storage.
+        const EdgeSegment *segment;
+        Point2 start, end;
+        /// Normalized directions at the start and end point, zero if degenerate.
+        Vector2 startDirection, endDirection;
+        /// Normalized sums of the directions meeting at the start and end corner, which delimit the endpoints' pseudo-distance domains.
+        Vector2 startCorner, endCorner;
+
+        /// For quadratic edges of a flat shape built with quadratic search hints, the hint for QuadraticSegment::signedDistance, otherwise NULL.
+        const QuadraticSearchHint *quadraticSearchHint;
+
+        /// Same as segment->signedDistance.
+        inline SignedDistance signedDistance(Point2 origin, double &param) const {
+            switch (type) {
+                case LinearSegment::EDGE_TYPE:
+                    return static_cast<const LinearSegment *>(segment)->LinearSegment::signedDistance(origin, param);
+                case QuadraticSegment::EDGE_TYPE:
+                    return static_cast<const QuadraticSegment *>(segment)->QuadraticSegment::signedDistance(origin, param);
+                case CubicSegment::EDGE_TYPE:
+                    return static_cast<const CubicSegment *>(segment)->CubicSegment::signedDistance(origin, param);
+            }
+            return segment->signedDistance(origin, param);
+        }
+        /// Same as segment->signedDistance, where seed is the param of a previous query from a nearby origin, or outside [0, 1].
+        /// With quadratic search hints, quadratic edges refine it instead of solving a cubic equation where they can (see QuadraticSegment::signedDistance).
+        inline SignedDistance signedDistance(Point2 origin, double &param, double seed) const {
+            if (quadraticSearchHint)
+                return static_cast<const QuadraticSegment *>(segment)->QuadraticSegment::signedDistance(origin, param, seed, quadraticSearchHint);
+            return signedDistance(origin, param);
+        }
+    };
+
+    /// The edges of all contours, in order.
+    std::vector<Edge> edges;
+
+    FlatShape();
+    explicit FlatShape(const Shape &shape, bool quadraticSearchHints = false);
+    /// Replaces the contents with the edges of shape. With quadraticSearchHints, also computes the search hint of each quadratic edge
+    /// so that its distance queries may be seeded by earlier ones, see Edge::signedDistance.
+    void build(const Shape &shape, bool quadraticSearchHints = false);
+
+private:
+    std::vector<LinearSegment> linearSegments;
+    std::vector<QuadraticSegment> quadraticSegments;
+    std::vector<CubicSegment> cubicSegments;
+    std::vector<EdgeHolder> otherSegments;
+    std::vector<QuadraticSearchHint> quadraticHints;
+
+    // Edges point into the segment arrays
+    FlatShape(const FlatShape &);
+    FlatShape &operator=(const FlatShape &);
+
+};
+
+}
@@ -5,6 +5,8 @@
 #include "Vector2.hpp"
 #include "edge-selectors.h"
 #include "contour-combiners.h"
+#include "FlatShape.h"
+#include "ShapeEdgeGrid.h"
 
 namespace msdfgen {
 
@@ -15,18 +17,25 @@ class ShapeDistanceFinder {
 public:
     typedef typename ContourCombiner::DistanceType DistanceType;
 
-    // Passed shape object must persist until the distance finder is destroyed!
-    explicit ShapeDistanceFinder(const Shape &shape);
+    /// Takes a flattened copy of the shape, which must not change afterwards. With quadraticSearchHints, the search on quadratic edges
+    /// is seeded by the previous query (see FlatShape::build).
+    explicit ShapeDistanceFinder(const Shape &shape, bool quadraticSearchHints = false);
     /// Finds the distance from origin. Not thread-safe! Is fastest when subsequent queries are close together.
     DistanceType distance(const Point2 &origin);
+    /// Finds the distance from origin visiting only the candidate edges of a cell of a grid built for the same shape. Origin must lie within the cell.
+    DistanceType distance(const Point2 &origin, const ShapeEdgeGrid &grid, int cell);
+    /// Finds the distances from a run of origins within a cell of the grid, in order. Linear edges are evaluated against the whole run at once.
+    void distances(const Point2 *origins, int count, DistanceType *distances, const ShapeEdgeGrid &grid, int cell);
 
     /// Finds the distance between shape and origin. Does not allocate result cache used to optimize performance of multiple queries.
     static DistanceType oneShotDistance(const Shape &shape, const Point2 &origin);
 
 private:
-    const Shape &shape;
+    FlatShape flatShape;
     ContourCombiner contourCombiner;
     std::vector<typename ContourCombiner::EdgeSelectorType::EdgeCache> shapeEdgeCache;
+    std::vector<SignedDistance> runDistances;
+    std::vector<double> runParams;
 
 };
 
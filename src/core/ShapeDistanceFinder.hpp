@@ -4,7 +4,7 @@
 namespace msdfgen {
 
 template <class ContourCombiner>
-ShapeDistanceFinder<ContourCombiner>::ShapeDistanceFinder(const Shape &shape) : shape(shape), contourCombiner(shape), shapeEdgeCache(shape.edgeCount()) { }
+ShapeDistanceFinder<ContourCombiner>::ShapeDistanceFinder(const Shape &shape, bool quadraticSearchHints) : flatShape(shape, quadraticSearchHints), contourCombiner(shape), shapeEdgeCache(flatShape.edges.size()) { }
 
 template <class ContourCombiner>
 typename ShapeDistanceFinder<ContourCombiner>::DistanceType ShapeDistanceFinder<ContourCombiner>::distance(const Point2 &origin) {
@@ -15,43 +15,63 @@ typename ShapeDistanceFinder<ContourCombiner>::DistanceType ShapeDistanceFinder<
     typename ContourCombiner::EdgeSelectorType::EdgeCache *edgeCache = shapeEdgeCache.empty() ? NULL : &shapeEdgeCache[0];
 #endif
 
-    for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour) {
-        if (!contour->edges.empty()) {
-            typename ContourCombiner::EdgeSelectorType &edgeSelector = contourCombiner.edgeSelector(int(contour-shape.contours.begin()));
-
-            const EdgeSegment *prevEdge = contour->edges.size() >= 2 ? *(contour->edges.end()-2) : *contour->edges.begin();
-            const EdgeSegment *curEdge = contour->edges.back();
-            for (std::vector<EdgeHolder>::const_iterator edge = contour->edges.begin(); edge != contour->edges.end(); ++edge) {
-                const EdgeSegment *nextEdge = *edge;
-                edgeSelector.addEdge(*edgeCache++, prevEdge, curEdge, nextEdge);
-                prevEdge = curEdge;
-                curEdge = nextEdge;
-            }
-        }
+    for (std::vector<FlatShape::Edge>::const_iterator edge = flatShape.edges.begin(); edge != flatShape.edges.end(); ++edge)
+        contourCombiner.edgeSelector(edge->contour).addEdge(*edgeCache++, *edge);
+
+    return contourCombiner.distance();
+}
+
+template <class ContourCombiner>
+typename ShapeDistanceFinder<ContourCombiner>::DistanceType ShapeDistanceFinder<ContourCombiner>::distance(const Point2 &origin, const ShapeEdgeGrid &grid, int cell) {
+    contourCombiner.reset(origin);
+
+    for (const unsigned *index = grid.cellBegin(cell), *end = grid.cellEnd(cell); index < end; ++index) {
+        const FlatShape::Edge &edge = flatShape.edges[*index];
+        contourCombiner.edgeSelector(edge.contour).addEdge(shapeEdgeCache[*index], edge);
     }
 
     return contourCombiner.distance();
 }
 
+template <class ContourCombiner>
+void ShapeDistanceFinder<ContourCombiner>::distances(const Point2 *origins, int count, DistanceType *distances, const ShapeEdgeGrid &grid, int cell) {
+    const unsigned *begin = grid.cellBegin(cell), *end = grid.cellEnd(cell);
+    size_t runSize = (size_t) (end-begin)*count;
+    if (runDistances.size() < runSize) {
+        runDistances.resize(runSize);
+        runParams.resize(runSize);
+    }
+    // Distances to linear edges are cheap enough to compute for every origin up front, curves are left to the edge cache
+    for (const unsigned *index = begin; index < end; ++index) {
+        const FlatShape::Edge &edge = flatShape.edges[*index];
+        if (edge.type == LinearSegment::EDGE_TYPE)
+            static_cast<const LinearSegment *>(edge.segment)->LinearSegment::signedDistances(origins, count, &runDistances[(index-begin)*count], &runParams[(index-begin)*count]);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        contourCombiner.reset(origins[i]);
+        for (const unsigned *index = begin; index < end; ++index) {
+            const FlatShape::Edge &edge = flatShape.edges[*index];
+            typename ContourCombiner::EdgeSelectorType &edgeSelector = contourCombiner.edgeSelector(edge.contour);
+            if (edge.type == LinearSegment::EDGE_TYPE) {
+                size_t run = (index-begin)*count+i;
+                edgeSelector.addEdge(shapeEdgeCache[*index], edge, runDistances[run], runParams[run]);
+            } else
+                edgeSelector.addEdge(shapeEdgeCache[*index], edge);
+        }
+        distances[i] = contourCombiner.distance();
+    }
+}
+
 template <class ContourCombiner>
 typename ShapeDistanceFinder<ContourCombiner>::DistanceType ShapeDistanceFinder<ContourCombiner>::oneShotDistance(const Shape &shape, const Point2 &origin) {
     ContourCombiner contourCombiner(shape);
     contourCombiner.reset(origin);
 
-    for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour) {
-        if (!contour->edges.empty()) {
-            typename ContourCombiner::EdgeSelectorType &edgeSelector = contourCombiner.edgeSelector(int(contour-shape.contours.begin()));
-
-            const EdgeSegment *prevEdge = contour->edges.size() >= 2 ? *(contour->edges.end()-2) : *contour->edges.begin();
-            const EdgeSegment *curEdge = contour->edges.back();
-            for (std::vector<EdgeHolder>::const_iterator edge = contour->edges.begin(); edge != contour->edges.end(); ++edge) {
-                const EdgeSegment *nextEdge = *edge;
-                typename ContourCombiner::EdgeSelectorType::EdgeCache dummy;
-                edgeSelector.addEdge(dummy, prevEdge, curEdge, nextEdge);
-                prevEdge = curEdge;
-                curEdge = nextEdge;
-            }
-        }
+    FlatShape flatShape(shape);
+    for (std::vector<FlatShape::Edge>::const_iterator edge = flatShape.edges.begin(); edge != flatShape.edges.end(); ++edge) {
+        typename ContourCombiner::EdgeSelectorType::EdgeCache dummy;
+        contourCombiner.edgeSelector(edge->contour).addEdge(dummy, *edge);
     }
 
     return contourCombiner.distance();
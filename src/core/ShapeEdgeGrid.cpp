@@ -0,0 +1,169 @@
+
+#include "ShapeEdgeGrid.h"
+
+#include <cfloat>
+#include "arithmetics.hpp"
+
+namespace msdfgen {
+
+// Slack relative to the coordinate magnitude, covers the rounding of the distances the bounds are compared against
+#define EDGE_GRID_TOLERANCE 1e-6
+
+namespace {
+
+struct EdgeBounds {
+    double l, b, r, t;
+    Point2 start;
+    Point2 aOrigin, bOrigin;
+    Vector2 aRay, bRay;
+    int channels;
+};
+
+}
+
+static double boxDistance(const Point2 &p, const EdgeBounds &bounds) {
+    double dx = max(max(bounds.l-p.x, p.x-bounds.r), 0.);
+    double dy = max(max(bounds.b-p.y, p.y-bounds.t), 0.);
+    return sqrt(dx*dx+dy*dy);
+}
+
+/// Distance between p and the half-line along which an endpoint's pseudo-distance is measured.
+static double rayDistance(const Point2 &p, const Point2 &origin, const Vector2 &ray) {
+    Vector2 op = p-origin;
+    if (dotProduct(op, ray) > 0)
+        return fabs(crossProduct(op, ray));
+    return op.length();
+}
+
+ShapeEdgeGrid::ShapeEdgeGrid() : width(0), height(0), cellSize(1), columns(0) { }
+
+ShapeEdgeGrid::ShapeEdgeGrid(const Shape &shape, const Projection &projection, int width, int height, Metric metric, int cellSize, double farDistance) : width(0), height(0), cellSize(1), columns(0) {
+    build(shape, projection, width, height, metric, cellSize, farDistance);
+}
+
+void ShapeEdgeGrid::build(const Shape &shape, const Projection &projection, int width, int height, Metric metric, int cellSize, double farDistance) {
+    this->width = width;
+    this->height = height;
+    this->cellSize = cellSize;
+    columns = (width+cellSize-1)/cellSize;
+    int rows = (height+cellSize-1)/cellSize;
+    cellOffsets.clear();
+    candidates.clear();
+    saturatedCells.clear();
+    // Pseudo-distances reach along the endpoint extensions, and multi-channel distances change sign away from the edges, so only true distance saturates
+    if (farDistance > 0 && metric == TRUE_DISTANCE)
+        saturatedCells.resize((size_t) columns*rows);
+
+    // Candidates are indexed like the edges of the flat shape, which are in the order ShapeDistanceFinder visits them
+    FlatShape flatShape(shape);
+    std::vector<int> contourStarts;
+    std::vector<EdgeBounds> bounds(flatShape.edges.size());
+    double extent = 1;
+    for (int i = 0; i < (int) flatShape.edges.size(); ++i) {
+        const FlatShape::Edge &edge = flatShape.edges[i];
+        while ((int) contourStarts.size() <= edge.contour)
+            contourStarts.push_back(i);
+        EdgeBounds &edgeBounds = bounds[i];
+        edgeBounds.l = DBL_MAX, edgeBounds.b = DBL_MAX, edgeBounds.r = -DBL_MAX, edgeBounds.t = -DBL_MAX;
+        edge.segment->bound(edgeBounds.l, edgeBounds.b, edgeBounds.r, edgeBounds.t);
+        edgeBounds.start = edge.start;
+        edgeBounds.aOrigin = edge.start;
+        edgeBounds.bOrigin = edge.end;
+        edgeBounds.aRay = -edge.startDirection;
+        edgeBounds.bRay = edge.endDirection;
+        // True and pseudo-distance selectors consider every edge, multi-channel selectors only those of each channel's color
+        edgeBounds.channels = metric == MULTI_DISTANCE ? edge.color&WHITE : 1;
+        extent = max(extent, max(max(fabs(edgeBounds.l), fabs(edgeBounds.r)), max(fabs(edgeBounds.b), fabs(edgeBounds.t))));
+    }
+    while (contourStarts.size() <= shape.contours.size())
+        contourStarts.push_back((int) flatShape.edges.size());
+
+    cellOffsets.reserve((size_t) columns*rows+1);
+    cellOffsets.push_back(0);
+    for (int cy = 0; cy < rows; ++cy) {
+        for (int cx = 0; cx < columns; ++cx) {
+            // The cell as a disc around the centers of its pixels
+            int x0 = cx*cellSize, y0 = cy*cellSize;
+            int x1 = min(x0+cellSize, width)-1, y1 = min(y0+cellSize, height)-1;
+            Point2 first = projection.unproject(Point2(x0+.5, y0+.5));
+            Point2 last = projection.unproject(Point2(x1+.5, y1+.5));
+            Point2 center = .5*(first+last);
+            double radius = .5*(last-first).length();
+            double tolerance = EDGE_GRID_TOLERANCE*(extent+fabs(center.x)+fabs(center.y)+radius);
+
+            for (int contourIndex = 0; contourIndex+1 < (int) contourStarts.size(); ++contourIndex) {
+                int start = contourStarts[contourIndex], end = contourStarts[contourIndex+1];
+                // No edge is farther from a pixel than its start point, so per channel, the nearest start point plus the radius
+                // bounds the contour's distance over the whole cell, and no edge or extension beyond that can change the result
+                double channelBounds[3] = { DBL_MAX, DBL_MAX, DBL_MAX };
+                for (int i = start; i < end; ++i) {
+                    double startDistance = (center-bounds[i].start).length();
+                    for (int channel = 0; channel < 3; ++channel)
+                        if (bounds[i].channels&1<<channel)
+                            channelBounds[channel] = min(channelBounds[channel], startDistance);
+                }
+                for (int i = start; i < end; ++i) {
+                    const EdgeBounds &edgeBounds = bounds[i];
+                    if (!edgeBounds.channels)
+                        continue;
+                    double limit = 0;
+                    for (int channel = 0; channel < 3; ++channel)
+                        if (edgeBounds.channels&1<<channel)
+                            limit = max(limit, channelBounds[channel]);
+                    // One radius to bound the distance at any pixel of the cell, another to measure the edge from any pixel
+                    limit += 2*radius+tolerance;
+                    if (
+                        boxDistance(center, edgeBounds) <= limit ||
+                        (metric != TRUE_DISTANCE && (
+                            rayDistance(center, edgeBounds.aOrigin, edgeBounds.aRay) <= limit ||
+                            rayDistance(center, edgeBounds.bOrigin, edgeBounds.bRay) <= limit
+                        ))
+                    )
+                        candidates.push_back((unsigned) i);
+                }
+            }
+            cellOffsets.push_back((unsigned) candidates.size());
+
+            if (!saturatedCells.empty()) {
+                // The distance to an edge is at least that to its bounding box
+                double nearest = DBL_MAX;
+                for (int i = 0; i < (int) bounds.size(); ++i)
+                    nearest = min(nearest, boxDistance(center, bounds[i]));
+                saturatedCells[(size_t) cy*columns+cx] = nearest-radius-tolerance >= farDistance;
+            }
+        }
+    }
+}
+
+bool ShapeEdgeGrid::empty() const {
+    return cellOffsets.empty();
+}
+
+int ShapeEdgeGrid::cellCount() const {
+    return cellOffsets.empty() ? 0 : (int) cellOffsets.size()-1;
+}
+
+int ShapeEdgeGrid::cell(int x, int y) const {
+    return y/cellSize*columns+x/cellSize;
+}
+
+void ShapeEdgeGrid::cellBounds(int cell, int &x0, int &y0, int &x1, int &y1) const {
+    x0 = cell%columns*cellSize;
+    y0 = cell/columns*cellSize;
+    x1 = min(x0+cellSize, width);
+    y1 = min(y0+cellSize, height);
+}
+
+const unsigned *ShapeEdgeGrid::cellBegin(int cell) const {
+    return candidates.empty() ? NULL : &candidates[0]+cellOffsets[cell];
+}
+
+const unsigned *ShapeEdgeGrid::cellEnd(int cell) const {
+    return candidates.empty() ? NULL : &candidates[0]+cellOffsets[cell+1];
+}
+
+bool ShapeEdgeGrid::saturated(int cell) const {
+    return !saturatedCells.empty() && saturatedCells[cell];
+}
+
+}
@@ -0,0 +1,78 @@
+
+#pragma once
+
+#include <vector>
+#include "Vector2.hpp"
+#include "Projection.h"
+#include "Shape.h"
+#include "FlatShape.h"
+#include "edge-selectors.h"
+
+namespace msdfgen {
+
+/// A uniform grid over the pixels of a distance field which lists, for each cell, the only edges that can affect the distance of a pixel inside it.
+/// The candidates are kept in the order ShapeDistanceFinder visits the shape, so a query restricted to them yields exactly the same distance as a full one.
+class ShapeEdgeGrid {
+
+public:
+    /// What a query compares: true distances only, also the pseudo-distances along the edges' endpoint extensions, or both per color channel.
+    enum Metric {
+        TRUE_DISTANCE,
+        PSEUDO_DISTANCE,
+        MULTI_DISTANCE
+    };
+
+    ShapeEdgeGrid();
+    ShapeEdgeGrid(const Shape &shape, const Projection &projection, int width, int height, Metric metric, int cellSize = 8, double farDistance = 0);
+    /// Lists the candidate edges of each cell of a width x height distance field. Replaces any previous contents.
+    /// With a positive farDistance and the TRUE_DISTANCE metric, also marks the cells whose pixels all lie at least that far from the shape, see saturated.
+    void build(const Shape &shape, const Projection &projection, int width, int height, Metric metric, int cellSize = 8, double farDistance = 0);
+    /// Returns true if the grid has not been built.
+    bool empty() const;
+    /// Number of cells, which are indexed row by row.
+    int cellCount() const;
+    /// Index of the cell containing pixel x, y (in unflipped generator coordinates).
+    int cell(int x, int y) const;
+    /// The pixels of a cell, x0 <= x < x1 and y0 <= y < y1 (in unflipped generator coordinates).
+    void cellBounds(int cell, int &x0, int &y0, int &x1, int &y1) const;
+    /// The candidates of a cell, as indices into the edges of a FlatShape of the same shape, which are also the indices of ShapeDistanceFinder's edge cache.
+    const unsigned *cellBegin(int cell) const;
+    const unsigned *cellEnd(int cell) const;
+    /// Returns true if no edge comes within farDistance of any pixel of the cell, so that every distance there is at least farDistance in magnitude.
+    bool saturated(int cell) const;
+
+private:
+    int width, height;
+    int cellSize;
+    int columns;
+    std::vector<bool> saturatedCells;
+    std::vector<unsigned> cellOffsets;
+    std::vector<unsigned> candidates;
+
+};
+
+/// The ShapeEdgeGrid metric matching an edge selector.
+template <class EdgeSelector>
+struct EdgeSelectorGridMetric;
+
+template <>
+struct EdgeSelectorGridMetric<TrueDistanceSelector> {
+    static const ShapeEdgeGrid::Metric metric = ShapeEdgeGrid::TRUE_DISTANCE;
+};
+
+template <>
+struct EdgeSelectorGridMetric<PseudoDistanceSelector> {
+    static const ShapeEdgeGrid::Metric metric = ShapeEdgeGrid::PSEUDO_DISTANCE;
+};
+
+template <>
+struct EdgeSelectorGridMetric<MultiDistanceSelector> {
+    static const ShapeEdgeGrid::Metric metric = ShapeEdgeGrid::MULTI_DISTANCE;
+};
+
+template <>
+struct EdgeSelectorGridMetric<MultiAndTrueDistanceSelector> {
+    static const ShapeEdgeGrid::Metric metric = ShapeEdgeGrid::MULTI_DISTANCE;
+};
+
+}
@@ -4,6 +4,12 @@
 #include "arithmetics.hpp"
 #include "equation-solver.h"
 
+// Batched distances use SSE2 in double precision where available, which keeps them bit-identical to the scalar path
+#if !defined(MSDFGEN_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define MSDFGEN_USE_SSE2
+    #include <emmintrin.h>
+#endif
+
 namespace msdfgen {
 
 EdgeSegment *EdgeSegment::create(Point2 p0, Point2 p1, EdgeColor edgeColor) {
@@ -25,6 +31,11 @@ EdgeSegment *EdgeSegment::create(Point2 p0, Point2 p1, Point2 p2, Point2 p3, Edg
     return new CubicSegment(p0, p1, p2, p3, edgeColor);
 }
 
+void EdgeSegment::signedDistances(const Point2 *origins, int count, SignedDistance *distances, double *params) const {
+    for (int i = 0; i < count; ++i)
+        distances[i] = signedDistance(origins[i], params[i]);
+}
+
 void EdgeSegment::distanceToPseudoDistance(SignedDistance &distance, Point2 origin, double param) const {
     if (param < 0) {
         Vector2 dir = direction(0).normalize();
@@ -184,6 +195,59 @@ SignedDistance LinearSegment::signedDistance(Point2 origin, double &param) const
     return SignedDistance(nonZeroSign(crossProduct(aq, ab))*endpointDistance, fabs(dotProduct(ab.normalize(), eq.normalize())));
 }
 
+#ifdef MSDFGEN_USE_SSE2
+static inline __m128d selectPd(__m128d mask, __m128d a, __m128d b) {
+    return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+#endif
+
+void LinearSegment::signedDistances(const Point2 *origins, int count, SignedDistance *distances, double *params) const {
+    int i = 0;
+#ifdef MSDFGEN_USE_SSE2
+    // Two origins per instruction, with the operations of signedDistance in the same order
+    Vector2 ab = p[1]-p[0];
+    Vector2 orthonormal = ab.getOrthonormal(false);
+    Vector2 abDir = ab.normalize();
+    const __m128d ax = _mm_set1_pd(p[0].x), ay = _mm_set1_pd(p[0].y);
+    const __m128d bx = _mm_set1_pd(p[1].x), by = _mm_set1_pd(p[1].y);
+    const __m128d abx = _mm_set1_pd(ab.x), aby = _mm_set1_pd(ab.y);
+    const __m128d abab = _mm_set1_pd(dotProduct(ab, ab));
+    const __m128d orthoX = _mm_set1_pd(orthonormal.x), orthoY = _mm_set1_pd(orthonormal.y);
+    const __m128d abDirX = _mm_set1_pd(abDir.x), abDirY = _mm_set1_pd(abDir.y);
+    const __m128d zero = _mm_setzero_pd(), half = _mm_set1_pd(.5), one = _mm_set1_pd(1), signBit = _mm_set1_pd(-0.);
+    for (; i+2 <= count; i += 2) {
+        __m128d ox = _mm_set_pd(origins[i+1].x, origins[i].x);
+        __m128d oy = _mm_set_pd(origins[i+1].y, origins[i].y);
+        __m128d aqx = _mm_sub_pd(ox, ax), aqy = _mm_sub_pd(oy, ay);
+        __m128d param = _mm_div_pd(_mm_add_pd(_mm_mul_pd(aqx, abx), _mm_mul_pd(aqy, aby)), abab);
+        __m128d nearB = _mm_cmpgt_pd(param, half);
+        __m128d eqx = _mm_sub_pd(selectPd(nearB, bx, ax), ox);
+        __m128d eqy = _mm_sub_pd(selectPd(nearB, by, ay), oy);
+        __m128d endpointDistance = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(eqx, eqx), _mm_mul_pd(eqy, eqy)));
+        __m128d orthoDistance = _mm_add_pd(_mm_mul_pd(orthoX, aqx), _mm_mul_pd(orthoY, aqy));
+        __m128d useOrtho = _mm_and_pd(
+            _mm_and_pd(_mm_cmpgt_pd(param, zero), _mm_cmplt_pd(param, one)),
+            _mm_cmplt_pd(_mm_andnot_pd(signBit, orthoDistance), endpointDistance)
+        );
+        __m128d cross = _mm_sub_pd(_mm_mul_pd(aqx, aby), _mm_mul_pd(aqy, abx));
+        __m128d endpointSigned = selectPd(_mm_cmpgt_pd(cross, zero), endpointDistance, _mm_xor_pd(endpointDistance, signBit));
+        // eq.normalize(), which yields (0, 1) for a zero vector
+        __m128d zeroLength = _mm_cmpeq_pd(endpointDistance, zero);
+        __m128d eqDirX = _mm_andnot_pd(zeroLength, _mm_div_pd(eqx, endpointDistance));
+        __m128d eqDirY = selectPd(zeroLength, one, _mm_div_pd(eqy, endpointDistance));
+        __m128d dot = _mm_andnot_pd(signBit, _mm_add_pd(_mm_mul_pd(abDirX, eqDirX), _mm_mul_pd(abDirY, eqDirY)));
+        double distance[2], alignment[2];
+        _mm_storeu_pd(distance, selectPd(useOrtho, orthoDistance, endpointSigned));
+        _mm_storeu_pd(alignment, _mm_andnot_pd(useOrtho, dot));
+        _mm_storeu_pd(params+i, param);
+        distances[i] = SignedDistance(distance[0], alignment[0]);
+        distances[i+1] = SignedDistance(distance[1], alignment[1]);
+    }
+#endif
+    for (; i < count; ++i)
+        distances[i] = signedDistance(origins[i], params[i]);
+}
+
 SignedDistance QuadraticSegment::signedDistance(Point2 origin, double &param) const {
     Vector2 qa = p[0]-origin;
     Vector2 ab = p[1]-p[0];
@@ -225,6 +289,81 @@ SignedDistance QuadraticSegment::signedDistance(Point2 origin, double &param) co
         return SignedDistance(minDistance, fabs(dotProduct(direction(1).normalize(), (p[2]-origin).normalize())));
 }
 
+/// Newton's method for the root in (0, 1) of the derivative of the squared distance (halved) to a quadratic curve, which increases there
+/// from f0 < 0 to f1 > 0. Steps that would leave the bracket of the root bisect it instead. Returns false if the root is not found within the step limit.
+static inline bool searchQuadraticDistance(double &t, double seed, double f0, double f1, const Vector2 &qa, const Vector2 &ab, const Vector2 &br) {
+    double lo = 0, hi = 1;
+    t = seed > 0 && seed < 1 ? seed : f0/(f0-f1);
+    for (int step = 0; step < MSDFGEN_QUADRATIC_SEARCH_STEPS; ++step) {
+        Vector2 d1 = ab+t*br;
+        Vector2 qe = qa+2*t*ab+t*t*br;
+        double f = dotProduct(qe, d1);
+        if (f < 0)
+            lo = t;
+        else if (f > 0)
+            hi = t;
+        else
+            return true;
+        double next = t-f/(2*dotProduct(d1, d1)+dotProduct(qe, br));
+        // Newton's method squares the error of this step, and the distance is stationary at the root, so it squares it once more
+        if (fabs(next-t) < 1e-6) {
+            t = next;
+            return true;
+        }
+        t = next > lo && next < hi ? next : .5*(lo+hi);
+    }
+    return false;
+}
+
+SignedDistance QuadraticSegment::signedDistance(Point2 origin, double &param, double seed, const QuadraticSearchHint *hint) const {
+    if (!hint || dotProduct(origin, hint->axis) >= hint->convexLimit)
+        return signedDistance(origin, param);
+    Vector2 qa = p[0]-origin;
+    Vector2 ab = p[1]-p[0];
+    Vector2 br = p[2]-p[1]-ab;
+    // With the squared distance convex, its derivative increases over (0, 1). If it changes sign there, its root is the closest point,
+    // otherwise the closest point is the endpoint where it is nearest to zero
+    double f0 = dotProduct(qa, ab);
+    double f1 = dotProduct(p[2]-origin, ab+br);
+    if (f0 < 0 && f1 > 0) {
+        double t;
+        if (!searchQuadraticDistance(t, seed, f0, f1, qa, ab, br))
+            return signedDistance(origin, param);
+        Vector2 qe = qa+2*t*ab+t*t*br;
+        param = t;
+        return SignedDistance(nonZeroSign(crossProduct(ab+t*br, qe))*qe.length(), 0);
+    }
+    double minDistance;
+    if (f0 >= 0) {
+        Vector2 epDir = direction(0);
+        minDistance = nonZeroSign(crossProduct(epDir, qa))*qa.length(); // distance from A
+        param = -dotProduct(qa, epDir)/dotProduct(epDir, epDir);
+    } else {
+        Vector2 epDir = direction(1);
+        minDistance = nonZeroSign(crossProduct(epDir, p[2]-origin))*(p[2]-origin).length(); // distance from B
+        param = dotProduct(origin-p[1], epDir)/dotProduct(epDir, epDir);
+    }
+
+    if (param >= 0 && param <= 1)
+        return SignedDistance(minDistance, 0);
+    if (param < .5)
+        return SignedDistance(minDistance, fabs(dotProduct(direction(0).normalize(), qa.normalize())));
+    else
+        return SignedDistance(minDistance, fabs(dotProduct(direction(1).normalize(), (p[2]-origin).normalize())));
+}
+
+void QuadraticSegment::searchHint(QuadraticSearchHint &hint) const {
+    Vector2 ab = p[1]-p[0];
+    Vector2 br = p[2]-p[1]-ab;
+    // The second derivative of the halved squared distance is 2*|ab+t*br|^2+dotProduct(point(t)-origin, br). Both dotProduct(ab+t*br, ab+t*br)
+    // and dotProduct(point(t), br) = dotProduct(p[0], br)+2*t*dotProduct(ab, br)+t*t*dotProduct(br, br) are smallest at the same t
+    double t = 0;
+    if (dotProduct(br, br) > 0)
+        t = min(max(-dotProduct(ab, br)/dotProduct(br, br), 0.), 1.);
+    hint.axis = br;
+    hint.convexLimit = 2*(ab+t*br).squaredLength()+dotProduct(point(t), br);
+}
+
 SignedDistance CubicSegment::signedDistance(Point2 origin, double &param) const {
     Vector2 qa = p[0]-origin;
     Vector2 ab = p[1]-p[0];
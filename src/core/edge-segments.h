@@ -10,6 +10,8 @@ namespace msdfgen {
 // Parameters for iterative search of closest point on a cubic Bezier curve. Increase for higher precision.
 #define MSDFGEN_CUBIC_SEARCH_STARTS 4
 #define MSDFGEN_CUBIC_SEARCH_STEPS 4
+// Maximum number of steps of the seeded search of closest point on a quadratic Bezier curve, before it falls back to solving the cubic equation.
+#define MSDFGEN_QUADRATIC_SEARCH_STEPS 12
 
 /// An abstract edge segment.
 class EdgeSegment {
@@ -37,6 +39,8 @@ public:
     virtual Vector2 directionChange(double param) const = 0;
     /// Returns the minimum signed distance between origin and the edge.
     virtual SignedDistance signedDistance(Point2 origin, double &param) const = 0;
+    /// Computes signedDistance for each of count origins, with identical results.
+    virtual void signedDistances(const Point2 *origins, int count, SignedDistance *distances, double *params) const;
     /// Converts a previously retrieved signed distance from origin to pseudo-distance.
     virtual void distanceToPseudoDistance(SignedDistance &distance, Point2 origin, double param) const;
     /// Outputs a list of (at most three) intersections (their X coordinates) with an infinite horizontal scanline at y and returns how many there are.
@@ -74,6 +78,7 @@ public:
     Vector2 directionChange(double param) const;
     double length() const;
     SignedDistance signedDistance(Point2 origin, double &param) const;
+    void signedDistances(const Point2 *origins, int count, SignedDistance *distances, double *params) const;
     int scanlineIntersections(double x[3], int dy[3], double y) const;
     void bound(double &l, double &b, double &r, double &t) const;
 
@@ -84,6 +89,14 @@ public:
 
 };
 
+/// What the closest-point search on a quadratic curve knows in advance about the curve.
+struct QuadraticSearchHint {
+    /// For origins where dotProduct(origin, axis) < convexLimit, the squared distance to the curve is convex over its parameter range,
+    /// so it has at most one minimum in (0, 1).
+    Vector2 axis;
+    double convexLimit;
+};
+
 /// A quadratic Bezier curve.
 class QuadraticSegment : public EdgeSegment {
 
@@ -103,6 +116,11 @@ public:
     Vector2 directionChange(double param) const;
     double length() const;
     SignedDistance signedDistance(Point2 origin, double &param) const;
+    /// Same as signedDistance, but where hint shows that the curve has at most one closest point within (0, 1), it is found by Newton's method
+    /// starting from seed, the parameter of the closest point to a nearby origin (ignored outside (0, 1)), instead of solving a cubic equation.
+    SignedDistance signedDistance(Point2 origin, double &param, double seed, const QuadraticSearchHint *hint) const;
+    /// Computes the hint for signedDistance.
+    void searchHint(QuadraticSearchHint &hint) const;
     int scanlineIntersections(double x[3], int dy[3], double y) const;
     void bound(double &l, double &b, double &r, double &t) const;
 
@@ -7,7 +7,7 @@ namespace msdfgen {
 
 #define DISTANCE_DELTA_FACTOR 1.001
 
-TrueDistanceSelector::EdgeCache::EdgeCache() : absDistance(0) { }
+TrueDistanceSelector::EdgeCache::EdgeCache() : absDistance(0), param(-1) { }
 
 void TrueDistanceSelector::reset(const Point2 &p) {
     double delta = DISTANCE_DELTA_FACTOR*(p-this->p).length();
@@ -15,18 +15,25 @@ void TrueDistanceSelector::reset(const Point2 &p) {
     this->p = p;
 }
 
-void TrueDistanceSelector::addEdge(EdgeCache &cache, const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge) {
+void TrueDistanceSelector::addEdge(EdgeCache &cache, const FlatShape::Edge &edge) {
     double delta = DISTANCE_DELTA_FACTOR*(p-cache.point).length();
     if (cache.absDistance-delta <= fabs(minDistance.distance)) {
-        double dummy;
-        SignedDistance distance = edge->signedDistance(p, dummy);
+        double param;
+        SignedDistance distance = edge.signedDistance(p, param, cache.param);
         if (distance < minDistance)
             minDistance = distance;
         cache.point = p;
         cache.absDistance = fabs(distance.distance);
+        cache.param = param;
     }
 }
 
+void TrueDistanceSelector::addEdge(EdgeCache &cache, const FlatShape::Edge &edge, const SignedDistance &distance, double param) {
+    // Consulting the cache would cost more than the comparison it saves
+    if (distance < minDistance)
+        minDistance = distance;
+}
+
 void TrueDistanceSelector::merge(const TrueDistanceSelector &other) {
     if (other.minDistance < minDistance)
         minDistance = other.minDistance;
@@ -36,7 +43,7 @@ TrueDistanceSelector::DistanceType TrueDistanceSelector::distance() const {
     return minDistance.distance;
 }
 
-PseudoDistanceSelectorBase::EdgeCache::EdgeCache() : absDistance(0), aDomainDistance(0), bDomainDistance(0), aPseudoDistance(0), bPseudoDistance(0) { }
+PseudoDistanceSelectorBase::EdgeCache::EdgeCache() : absDistance(0), aDomainDistance(0), bDomainDistance(0), aPseudoDistance(0), bPseudoDistance(0), param(-1) { }
 
 bool PseudoDistanceSelectorBase::getPseudoDistance(double &distance, const Vector2 &ep, const Vector2 &edgeDir) {
     double ts = dotProduct(ep, edgeDir);
@@ -125,37 +132,43 @@ void PseudoDistanceSelector::reset(const Point2 &p) {
     this->p = p;
 }
 
-void PseudoDistanceSelector::addEdge(EdgeCache &cache, const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge) {
-    if (isEdgeRelevant(cache, edge, p)) {
+void PseudoDistanceSelector::addEdge(EdgeCache &cache, const FlatShape::Edge &edge) {
+    if (isEdgeRelevant(cache, edge.segment, p)) {
         double param;
-        SignedDistance distance = edge->signedDistance(p, param);
-        addEdgeTrueDistance(edge, distance, param);
-        cache.point = p;
-        cache.absDistance = fabs(distance.distance);
+        SignedDistance distance = edge.signedDistance(p, param, cache.param);
+        addRelevantEdge(cache, edge, distance, param);
+    }
+}
 
-        Vector2 ap = p-edge->point(0);
-        Vector2 bp = p-edge->point(1);
-        Vector2 aDir = edge->direction(0).normalize(true);
-        Vector2 bDir = edge->direction(1).normalize(true);
-        Vector2 prevDir = prevEdge->direction(1).normalize(true);
-        Vector2 nextDir = nextEdge->direction(0).normalize(true);
-        double add = dotProduct(ap, (prevDir+aDir).normalize(true));
-        double bdd = -dotProduct(bp, (bDir+nextDir).normalize(true));
-        if (add > 0) {
-            double pd = distance.distance;
-            if (getPseudoDistance(pd, ap, -aDir))
-                addEdgePseudoDistance(pd = -pd);
-            cache.aPseudoDistance = pd;
-        }
-        if (bdd > 0) {
-            double pd = distance.distance;
-            if (getPseudoDistance(pd, bp, bDir))
-                addEdgePseudoDistance(pd);
-            cache.bPseudoDistance = pd;
-        }
-        cache.aDomainDistance = add;
-        cache.bDomainDistance = bdd;
+void PseudoDistanceSelector::addEdge(EdgeCache &cache, const FlatShape::Edge &edge, const SignedDistance &distance, double param) {
+    if (isEdgeRelevant(cache, edge.segment, p))
+        addRelevantEdge(cache, edge, distance, param);
+}
+
+void PseudoDistanceSelector::addRelevantEdge(EdgeCache &cache, const FlatShape::Edge &edge, const SignedDistance &distance, double param) {
+    addEdgeTrueDistance(edge.segment, distance, param);
+    cache.point = p;
+    cache.absDistance = fabs(distance.distance);
+    cache.param = param;
+
+    Vector2 ap = p-edge.start;
+    Vector2 bp = p-edge.end;
+    double add = dotProduct(ap, edge.startCorner);
+    double bdd = -dotProduct(bp, edge.endCorner);
+    if (add > 0) {
+        double pd = distance.distance;
+        if (getPseudoDistance(pd, ap, -edge.startDirection))
+            addEdgePseudoDistance(pd = -pd);
+        cache.aPseudoDistance = pd;
+    }
+    if (bdd > 0) {
+        double pd = distance.distance;
+        if (getPseudoDistance(pd, bp, edge.endDirection))
+            addEdgePseudoDistance(pd);
+        cache.bPseudoDistance = pd;
     }
+    cache.aDomainDistance = add;
+    cache.bDomainDistance = bdd;
 }
 
 PseudoDistanceSelector::DistanceType PseudoDistanceSelector::distance() const {
@@ -170,59 +183,69 @@ void MultiDistanceSelector::reset(const Point2 &p) {
     this->p = p;
 }
 
-void MultiDistanceSelector::addEdge(EdgeCache &cache, const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge) {
-    if (
-        (edge->color&RED && r.isEdgeRelevant(cache, edge, p)) ||
-        (edge->color&GREEN && g.isEdgeRelevant(cache, edge, p)) ||
-        (edge->color&BLUE && b.isEdgeRelevant(cache, edge, p))
-    ) {
+bool MultiDistanceSelector::isEdgeRelevant(const EdgeCache &cache, const FlatShape::Edge &edge) const {
+    return (
+        (edge.color&RED && r.isEdgeRelevant(cache, edge.segment, p)) ||
+        (edge.color&GREEN && g.isEdgeRelevant(cache, edge.segment, p)) ||
+        (edge.color&BLUE && b.isEdgeRelevant(cache, edge.segment, p))
+    );
+}
+
+void MultiDistanceSelector::addEdge(EdgeCache &cache, const FlatShape::Edge &edge) {
+    if (isEdgeRelevant(cache, edge)) {
         double param;
-        SignedDistance distance = edge->signedDistance(p, param);
-        if (edge->color&RED)
-            r.addEdgeTrueDistance(edge, distance, param);
-        if (edge->color&GREEN)
-            g.addEdgeTrueDistance(edge, distance, param);
-        if (edge->color&BLUE)
-            b.addEdgeTrueDistance(edge, distance, param);
-        cache.point = p;
-        cache.absDistance = fabs(distance.distance);
+        SignedDistance distance = edge.signedDistance(p, param, cache.param);
+        addRelevantEdge(cache, edge, distance, param);
+    }
+}
+
+void MultiDistanceSelector::addEdge(EdgeCache &cache, const FlatShape::Edge &edge, const SignedDistance &distance, double param) {
+    if (isEdgeRelevant(cache, edge))
+        addRelevantEdge(cache, edge, distance, param);
+}
+
+void MultiDistanceSelector::addRelevantEdge(EdgeCache &cache, const FlatShape::Edge &edge, const SignedDistance &distance, double param) {
+    if (edge.color&RED)
+        r.addEdgeTrueDistance(edge.segment, distance, param);
+    if (edge.color&GREEN)
+        g.addEdgeTrueDistance(edge.segment, distance, param);
+    if (edge.color&BLUE)
+        b.addEdgeTrueDistance(edge.segment, distance, param);
+    cache.point = p;
+    cache.absDistance = fabs(distance.distance);
+    cache.param = param;
 
-        Vector2 ap = p-edge->point(0);
-        Vector2 bp = p-edge->point(1);
-        Vector2 aDir = edge->direction(0).normalize(true);
-        Vector2 bDir = edge->direction(1).normalize(true);
-        Vector2 prevDir = prevEdge->direction(1).normalize(true);
-        Vector2 nextDir = nextEdge->direction(0).normalize(true);
-        double add = dotProduct(ap, (prevDir+aDir).normalize(true));
-        double bdd = -dotProduct(bp, (bDir+nextDir).normalize(true));
-        if (add > 0) {
-            double pd = distance.distance;
-            if (PseudoDistanceSelectorBase::getPseudoDistance(pd, ap, -aDir)) {
-                pd = -pd;
-                if (edge->color&RED)
-                    r.addEdgePseudoDistance(pd);
-                if (edge->color&GREEN)
-                    g.addEdgePseudoDistance(pd);
-                if (edge->color&BLUE)
-                    b.addEdgePseudoDistance(pd);
-            }
-            cache.aPseudoDistance = pd;
+    Vector2 ap = p-edge.start;
+    Vector2 bp = p-edge.end;
+    double add = dotProduct(ap, edge.startCorner);
+    double bdd = -dotProduct(bp, edge.endCorner);
+    if (add > 0) {
+        double pd = distance.distance;
+        if (PseudoDistanceSelectorBase::getPseudoDistance(pd, ap, -edge.startDirection)) {
+            pd = -pd;
+            if (edge.color&RED)
+                r.addEdgePseudoDistance(pd);
+            if (edge.color&GREEN)
+                g.addEdgePseudoDistance(pd);
+            if (edge.color&BLUE)
+                b.addEdgePseudoDistance(pd);
         }
-        if (bdd > 0) {
-            double pd = distance.distance;
-            if (PseudoDistanceSelectorBase::getPseudoDistance(pd, bp, bDir)) {
-                if (edge->color&RED)
-                    r.addEdgePseudoDistance(pd);
-                if (edge->color&GREEN)
-                    g.addEdgePseudoDistance(pd);
-                if (edge->color&BLUE)
-                    b.addEdgePseudoDistance(pd);
-            }
-            cache.bPseudoDistance = pd;
+        cache.aPseudoDistance = pd;
+    }
+    if (bdd > 0) {
+        double pd = distance.distance;
+        if (PseudoDistanceSelectorBase::getPseudoDistance(pd, bp, edge.endDirection)) {
+            if (edge.color&RED)
+                r.addEdgePseudoDistance(pd);
+            if (edge.color&GREEN)
+                g.addEdgePseudoDistance(pd);
+            if (edge.color&BLUE)
+                b.addEdgePseudoDistance(pd);
         }
-        cache.aDomainDistance = add;
-        cache.bDomainDistance = bdd;
+        cache.bPseudoDistance = pd;
     }
+    cache.aDomainDistance = add;
+    cache.bDomainDistance = bdd;
 }
 
 void MultiDistanceSelector::merge(const MultiDistanceSelector &other) {
@@ -4,6 +4,7 @@
 #include "Vector2.hpp"
 #include "SignedDistance.hpp"
 #include "edge-segments.h"
+#include "FlatShape.h"
 
 namespace msdfgen {
 
@@ -23,12 +24,16 @@ public:
     struct EdgeCache {
         Point2 point;
         double absDistance;
+        /// The parameter of the edge's closest point to point, which seeds the next search (see FlatShape::Edge::signedDistance).
+        double param;
 
         EdgeCache();
     };
 
     void reset(const Point2 &p);
-    void addEdge(EdgeCache &cache, const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge);
+    void addEdge(EdgeCache &cache, const FlatShape::Edge &edge);
+    /// Adds an edge whose signed distance from the current point was computed in advance, e.g. by EdgeSegment::signedDistances.
+    void addEdge(EdgeCache &cache, const FlatShape::Edge &edge, const SignedDistance &distance, double param);
     void merge(const TrueDistanceSelector &other);
     DistanceType distance() const;
 
@@ -46,6 +51,8 @@ public:
         double absDistance;
         double aDomainDistance, bDomainDistance;
         double aPseudoDistance, bPseudoDistance;
+        /// The parameter of the edge's closest point to point, which seeds the next search (see FlatShape::Edge::signedDistance).
+        double param;
 
         EdgeCache();
     };
@@ -77,12 +84,15 @@ public:
     typedef double DistanceType;
 
     void reset(const Point2 &p);
-    void addEdge(EdgeCache &cache, const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge);
+    void addEdge(EdgeCache &cache, const FlatShape::Edge &edge);
+    void addEdge(EdgeCache &cache, const FlatShape::Edge &edge, const SignedDistance &distance, double param);
     DistanceType distance() const;
 
 private:
     Point2 p;
 
+    void addRelevantEdge(EdgeCache &cache, const FlatShape::Edge &edge, const SignedDistance &distance, double param);
+
 };
 
 /// Selects the nearest edge for each of the three channels by its pseudo-distance.
@@ -93,7 +103,8 @@ public:
     typedef PseudoDistanceSelectorBase::EdgeCache EdgeCache;
 
     void reset(const Point2 &p);
-    void addEdge(EdgeCache &cache, const EdgeSegment *prevEdge, const EdgeSegment *edge, const EdgeSegment *nextEdge);
+    void addEdge(EdgeCache &cache, const FlatShape::Edge &edge);
+    void addEdge(EdgeCache &cache, const FlatShape::Edge &edge, const SignedDistance &distance, double param);
     void merge(const MultiDistanceSelector &other);
     DistanceType distance() const;
     SignedDistance trueDistance() const;
@@ -102,6 +113,9 @@ private:
     Point2 p;
     PseudoDistanceSelectorBase r, g, b;
 
+    bool isEdgeRelevant(const EdgeCache &cache, const FlatShape::Edge &edge) const;
+    void addRelevantEdge(EdgeCache &cache, const FlatShape::Edge &edge, const SignedDistance &distance, double param);
+
 };
 
 /// Selects the nearest edge for each of the three color channels by its pseudo-distance and by true distance for the alpha channel.
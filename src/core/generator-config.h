@@ -50,8 +50,16 @@ struct ErrorCorrectionConfig {
 struct GeneratorConfig {
     /// Specifies whether to use the version of the algorithm that supports overlapping contours with the same winding. May be set to false to improve performance when no such contours are present.
     bool overlapSupport;
+    /// Specifies whether to first list the edges that can affect each small block of pixels (see ShapeEdgeGrid), so that each pixel only visits those. Produces the same output, faster for shapes with many edges.
+    bool edgeGrid;
+    /// Specifies whether to skip the distance of pixels that are provably beyond half the range from the shape, and store the value their distance clamps to (0 or 1) instead.
+    /// Implies edgeGrid. Only applies to true distance fields (generateSDF) of shapes whose contours neither overlap nor cross. Produces the same 8-bit output, but floating-point output is clamped in those pixels.
+    bool skipFarField;
+    /// Specifies whether the closest point on a quadratic edge is found by refining the one of the previous pixel, where the curve provably has only one,
+    /// instead of solving a cubic equation. Faster for shapes made of quadratics, but the result may differ from the default one by rounding.
+    bool quadraticSearchHints;
 
-    inline explicit GeneratorConfig(bool overlapSupport = true) : overlapSupport(overlapSupport) { }
+    inline explicit GeneratorConfig(bool overlapSupport = true, bool edgeGrid = false, bool skipFarField = false, bool quadraticSearchHints = false) : overlapSupport(overlapSupport), edgeGrid(edgeGrid), skipFarField(skipFarField), quadraticSearchHints(quadraticSearchHints) { }
 };
 
 /// The configuration of the multi-channel distance field generator algorithm.
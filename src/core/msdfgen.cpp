@@ -1,109 +1,272 @@
 
 #include "../msdfgen.h"
 
+#include <cstdlib>
 #include <vector>
 #include "edge-selectors.h"
 #include "contour-combiners.h"
 #include "ShapeDistanceFinder.h"
+#include "ShapeEdgeGrid.h"
 
 namespace msdfgen {
 
-template <typename DistanceType>
+// Stores a normalized distance into a pixel of the output type
+inline void storePixel(float &pixel, float value) {
+    pixel = value;
+}
+
+inline void storePixel(byte &pixel, float value) {
+    pixel = pixelFloatToByte(value);
+}
+
+template <typename DistanceType, typename T = float>
 class DistancePixelConversion;
 
-template <>
-class DistancePixelConversion<double> {
+template <typename T>
+class DistancePixelConversion<double, T> {
     double invRange;
 public:
-    typedef BitmapRef<float, 1> BitmapRefType;
+    typedef BitmapRef<T, 1> BitmapRefType;
     inline explicit DistancePixelConversion(double range) : invRange(1/range) { }
-    inline void operator()(float *pixels, double distance) const {
-        *pixels = float(invRange*distance+.5);
+    inline void operator()(T *pixels, double distance) const {
+        storePixel(*pixels, float(invRange*distance+.5));
     }
 };
 
-template <>
-class DistancePixelConversion<MultiDistance> {
+template <typename T>
+class DistancePixelConversion<MultiDistance, T> {
     double invRange;
 public:
-    typedef BitmapRef<float, 3> BitmapRefType;
+    typedef BitmapRef<T, 3> BitmapRefType;
     inline explicit DistancePixelConversion(double range) : invRange(1/range) { }
-    inline void operator()(float *pixels, const MultiDistance &distance) const {
-        pixels[0] = float(invRange*distance.r+.5);
-        pixels[1] = float(invRange*distance.g+.5);
-        pixels[2] = float(invRange*distance.b+.5);
+    inline void operator()(T *pixels, const MultiDistance &distance) const {
+        storePixel(pixels[0], float(invRange*distance.r+.5));
+        storePixel(pixels[1], float(invRange*distance.g+.5));
+        storePixel(pixels[2], float(invRange*distance.b+.5));
     }
 };
 
-template <>
-class DistancePixelConversion<MultiAndTrueDistance> {
+template <typename T>
+class DistancePixelConversion<MultiAndTrueDistance, T> {
     double invRange;
 public:
-    typedef BitmapRef<float, 4> BitmapRefType;
+    typedef BitmapRef<T, 4> BitmapRefType;
     inline explicit DistancePixelConversion(double range) : invRange(1/range) { }
-    inline void operator()(float *pixels, const MultiAndTrueDistance &distance) const {
-        pixels[0] = float(invRange*distance.r+.5);
-        pixels[1] = float(invRange*distance.g+.5);
-        pixels[2] = float(invRange*distance.b+.5);
-        pixels[3] = float(invRange*distance.a+.5);
+    inline void operator()(T *pixels, const MultiAndTrueDistance &distance) const {
+        storePixel(pixels[0], float(invRange*distance.r+.5));
+        storePixel(pixels[1], float(invRange*distance.g+.5));
+        storePixel(pixels[2], float(invRange*distance.b+.5));
+        storePixel(pixels[3], float(invRange*distance.a+.5));
     }
 };
 
-template <class ContourCombiner>
-void generateDistanceField(const typename DistancePixelConversion<typename ContourCombiner::DistanceType>::BitmapRefType &output, const Shape &shape, const Projection &projection, double range) {
-    DistancePixelConversion<typename ContourCombiner::DistanceType> distancePixelConversion(range);
+// Replaces each channel of a distance that is known to lie beyond the limit with the limit, keeping its sign
+inline double saturate(double distance, double limit) {
+    return distance > 0 ? limit : -limit;
+}
+
+inline void saturate(double &distance, const double &exactDistance, double limit) {
+    distance = saturate(exactDistance, limit);
+}
+
+inline void saturate(MultiDistance &distance, const MultiDistance &exactDistance, double limit) {
+    distance.r = saturate(exactDistance.r, limit);
+    distance.g = saturate(exactDistance.g, limit);
+    distance.b = saturate(exactDistance.b, limit);
+}
+
+inline void saturate(MultiAndTrueDistance &distance, const MultiAndTrueDistance &exactDistance, double limit) {
+    distance.r = saturate(exactDistance.r, limit);
+    distance.g = saturate(exactDistance.g, limit);
+    distance.b = saturate(exactDistance.b, limit);
+    distance.a = saturate(exactDistance.a, limit);
+}
+
+static bool isMostlyLinear(const Shape &shape) {
+    int linearEdges = 0;
+    for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour)
+        for (std::vector<EdgeHolder>::const_iterator edge = contour->edges.begin(); edge != contour->edges.end(); ++edge)
+            linearEdges += (*edge)->type() == LinearSegment::EDGE_TYPE;
+    return 2*linearEdges >= shape.edgeCount();
+}
+
+static int compareIntersections(const void *a, const void *b) {
+    return sign(reinterpret_cast<const Scanline::Intersection *>(a)->x-reinterpret_cast<const Scanline::Intersection *>(b)->x);
+}
+
+/// Returns true if along every pixel row, the winding number of the shape is either zero or the same one value (1 or -1), meaning its contours neither overlap nor cross.
+/// Only then does the sign of the distance stay the same across any area that no edge passes through.
+static bool hasSimpleWinding(const Shape &shape, const Projection &projection, int height) {
+    std::vector<Scanline::Intersection> intersections;
+    int fill = 0;
+    for (int y = 0; y < height; ++y) {
+        double scanlineY = projection.unprojectY(y+.5);
+        intersections.clear();
+        for (std::vector<Contour>::const_iterator contour = shape.contours.begin(); contour != shape.contours.end(); ++contour)
+            for (std::vector<EdgeHolder>::const_iterator edge = contour->edges.begin(); edge != contour->edges.end(); ++edge) {
+                double x[3];
+                int dy[3];
+                int n = (*edge)->scanlineIntersections(x, dy, scanlineY);
+                for (int i = 0; i < n; ++i) {
+                    Scanline::Intersection intersection = { x[i], dy[i] };
+                    intersections.push_back(intersection);
+                }
+            }
+        if (intersections.empty())
+            continue;
+        qsort(&intersections[0], intersections.size(), sizeof(Scanline::Intersection), compareIntersections);
+        int winding = 0;
+        for (size_t i = 0; i < intersections.size(); ++i) {
+            winding += intersections[i].direction;
+            // Coincident intersections are only checked together
+            if (i+1 < intersections.size() && intersections[i+1].x == intersections[i].x)
+                continue;
+            if (winding) {
+                if (!fill)
+                    fill = winding;
+                if (winding != fill || (winding != 1 && winding != -1))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <class ContourCombiner, typename T = float>
+void generateDistanceField(const typename DistancePixelConversion<typename ContourCombiner::DistanceType, T>::BitmapRefType &output, const Shape &shape, const Projection &projection, double range, const GeneratorConfig &config) {
+    DistancePixelConversion<typename ContourCombiner::DistanceType, T> distancePixelConversion(range);
+    ShapeEdgeGrid edgeGrid;
+    // Pixels at least half the range from the shape convert to exactly 0 or 1, so only the sign of their distance is needed
+    bool skipFarField = config.skipFarField && EdgeSelectorGridMetric<typename ContourCombiner::EdgeSelectorType>::metric == ShapeEdgeGrid::TRUE_DISTANCE && hasSimpleWinding(shape, projection, output.height);
+    if (config.edgeGrid || skipFarField)
+        edgeGrid.build(shape, projection, output.width, output.height, EdgeSelectorGridMetric<typename ContourCombiner::EdgeSelectorType>::metric, 8, skipFarField ? .5*range : 0);
+    // For true distance of mostly polygonal shapes, linear edges are evaluated against all pixels of a cell at once.
+    // Elsewhere the edge cache skips enough evaluations one pixel at a time that batching them does not pay off
+    bool runs = !edgeGrid.empty() && EdgeSelectorGridMetric<typename ContourCombiner::EdgeSelectorType>::metric == ShapeEdgeGrid::TRUE_DISTANCE && isMostlyLinear(shape);
 #ifdef MSDFGEN_USE_OPENMP
     #pragma omp parallel
 #endif
     {
-        ShapeDistanceFinder<ContourCombiner> distanceFinder(shape);
-        bool rightToLeft = false;
+        ShapeDistanceFinder<ContourCombiner> distanceFinder(shape, config.quadraticSearchHints);
+        if (edgeGrid.empty()) {
+            bool rightToLeft = false;
+#ifdef MSDFGEN_USE_OPENMP
+            #pragma omp for
+#endif
+            for (int y = 0; y < output.height; ++y) {
+                int row = shape.inverseYAxis ? output.height-y-1 : y;
+                for (int col = 0; col < output.width; ++col) {
+                    int x = rightToLeft ? output.width-col-1 : col;
+                    Point2 p = projection.unproject(Point2(x+.5, y+.5));
+                    distancePixelConversion(output(x, row), distanceFinder.distance(p));
+                }
+                rightToLeft = !rightToLeft;
+            }
+        } else {
+            // The grid is traversed one cell at a time, so each pixel's short list of candidates is the one just used by its neighbor,
+            // and each cell is an independent unit of work. Within a cell, pixels are visited in a serpentine order for the edge cache
+            std::vector<int> runX, runY;
+            std::vector<Point2> runOrigins;
+            std::vector<typename ContourCombiner::DistanceType> runDistances;
+            typename ContourCombiner::DistanceType saturatedDistance;
 #ifdef MSDFGEN_USE_OPENMP
-        #pragma omp for
+            #pragma omp for schedule(dynamic)
 #endif
-        for (int y = 0; y < output.height; ++y) {
-            int row = shape.inverseYAxis ? output.height-y-1 : y;
-            for (int col = 0; col < output.width; ++col) {
-                int x = rightToLeft ? output.width-col-1 : col;
-                Point2 p = projection.unproject(Point2(x+.5, y+.5));
-                typename ContourCombiner::DistanceType distance = distanceFinder.distance(p);
-                distancePixelConversion(output(x, row), distance);
+            for (int cell = 0; cell < edgeGrid.cellCount(); ++cell) {
+                int x0, y0, x1, y1;
+                edgeGrid.cellBounds(cell, x0, y0, x1, y1);
+                if (edgeGrid.saturated(cell)) {
+                    // The sign cannot change within the cell, so one exact distance is enough
+                    saturate(saturatedDistance, distanceFinder.distance(projection.unproject(Point2(x0+.5, y0+.5)), edgeGrid, cell), .5*range);
+                    for (int y = y0; y < y1; ++y) {
+                        int row = shape.inverseYAxis ? output.height-y-1 : y;
+                        for (int x = x0; x < x1; ++x)
+                            distancePixelConversion(output(x, row), saturatedDistance);
+                    }
+                    continue;
+                }
+                if (!runs) {
+                    bool rightToLeft = false;
+                    for (int y = y0; y < y1; ++y) {
+                        int row = shape.inverseYAxis ? output.height-y-1 : y;
+                        for (int col = x0; col < x1; ++col) {
+                            int x = rightToLeft ? x1-col+x0-1 : col;
+                            Point2 p = projection.unproject(Point2(x+.5, y+.5));
+                            distancePixelConversion(output(x, row), distanceFinder.distance(p, edgeGrid, cell));
+                        }
+                        rightToLeft = !rightToLeft;
+                    }
+                } else {
+                    int count = (x1-x0)*(y1-y0);
+                    if ((int) runOrigins.size() < count) {
+                        runX.resize(count);
+                        runY.resize(count);
+                        runOrigins.resize(count);
+                        runDistances.resize(count);
+                    }
+                    int i = 0;
+                    bool rightToLeft = false;
+                    for (int y = y0; y < y1; ++y) {
+                        for (int col = x0; col < x1; ++col, ++i) {
+                            runX[i] = rightToLeft ? x1-col+x0-1 : col;
+                            runY[i] = shape.inverseYAxis ? output.height-y-1 : y;
+                            runOrigins[i] = projection.unproject(Point2(runX[i]+.5, y+.5));
+                        }
+                        rightToLeft = !rightToLeft;
+                    }
+                    distanceFinder.distances(&runOrigins[0], count, &runDistances[0], edgeGrid, cell);
+                    for (i = 0; i < count; ++i)
+                        distancePixelConversion(output(runX[i], runY[i]), runDistances[i]);
+                }
             }
-            rightToLeft = !rightToLeft;
         }
     }
 }
 
 void generateSDF(const BitmapRef<float, 1> &output, const Shape &shape, const Projection &projection, double range, const GeneratorConfig &config) {
     if (config.overlapSupport)
-        generateDistanceField<OverlappingContourCombiner<TrueDistanceSelector> >(output, shape, projection, range);
+        generateDistanceField<OverlappingContourCombiner<TrueDistanceSelector> >(output, shape, projection, range, config);
     else
-        generateDistanceField<SimpleContourCombiner<TrueDistanceSelector> >(output, shape, projection, range);
+        generateDistanceField<SimpleContourCombiner<TrueDistanceSelector> >(output, shape, projection, range, config);
 }
 
 void generatePseudoSDF(const BitmapRef<float, 1> &output, const Shape &shape, const Projection &projection, double range, const GeneratorConfig &config) {
     if (config.overlapSupport)
-        generateDistanceField<OverlappingContourCombiner<PseudoDistanceSelector> >(output, shape, projection, range);
+        generateDistanceField<OverlappingContourCombiner<PseudoDistanceSelector> >(output, shape, projection, range, config);
     else
-        generateDistanceField<SimpleContourCombiner<PseudoDistanceSelector> >(output, shape, projection, range);
+        generateDistanceField<SimpleContourCombiner<PseudoDistanceSelector> >(output, shape, projection, range, config);
 }
 
 void generateMSDF(const BitmapRef<float, 3> &output, const Shape &shape, const Projection &projection, double range, const MSDFGeneratorConfig &config) {
     if (config.overlapSupport)
-        generateDistanceField<OverlappingContourCombiner<MultiDistanceSelector> >(output, shape, projection, range);
+        generateDistanceField<OverlappingContourCombiner<MultiDistanceSelector> >(output, shape, projection, range, config);
     else
-        generateDistanceField<SimpleContourCombiner<MultiDistanceSelector> >(output, shape, projection, range);
+        generateDistanceField<SimpleContourCombiner<MultiDistanceSelector> >(output, shape, projection, range, config);
     msdfErrorCorrection(output, shape, projection, range, config);
 }
 
 void generateMTSDF(const BitmapRef<float, 4> &output, const Shape &shape, const Projection &projection, double range, const MSDFGeneratorConfig &config) {
     if (config.overlapSupport)
-        generateDistanceField<OverlappingContourCombiner<MultiAndTrueDistanceSelector> >(output, shape, projection, range);
+        generateDistanceField<OverlappingContourCombiner<MultiAndTrueDistanceSelector> >(output, shape, projection, range, config);
     else
-        generateDistanceField<SimpleContourCombiner<MultiAndTrueDistanceSelector> >(output, shape, projection, range);
+        generateDistanceField<SimpleContourCombiner<MultiAndTrueDistanceSelector> >(output, shape, projection, range, config);
     msdfErrorCorrection(output, shape, projection, range, config);
 }
 
+void generateSDF(const BitmapRef<byte, 1> &output, const Shape &shape, const Projection &projection, double range, const GeneratorConfig &config) {
+    if (config.overlapSupport)
+        generateDistanceField<OverlappingContourCombiner<TrueDistanceSelector>, byte>(output, shape, projection, range, config);
+    else
+        generateDistanceField<SimpleContourCombiner<TrueDistanceSelector>, byte>(output, shape, projection, range, config);
+}
+
+void generatePseudoSDF(const BitmapRef<byte, 1> &output, const Shape &shape, const Projection &projection, double range, const GeneratorConfig &config) {
+    if (config.overlapSupport)
+        generateDistanceField<OverlappingContourCombiner<PseudoDistanceSelector>, byte>(output, shape, projection, range, config);
+    else
+        generateDistanceField<SimpleContourCombiner<PseudoDistanceSelector>, byte>(output, shape, projection, range, config);
+}
+
 // Legacy API
 
 void generateSDF(const BitmapRef<float, 1> &output, const Shape &shape, double range, const Vector2 &scale, const Vector2 &translate, bool overlapSupport) {
@@ -340,6 +340,75 @@ bool loadSvgShape(Shape &output, const char *filename, int pathIndex, Vector2 *d
     return buildShapeFromSvgPath(output, pd, ENDPOINT_SNAP_RANGE_PROPORTION*dims.length());
 }
 
+static std::string readStyleProperty(const tinyxml2::XMLElement *element, const char *name) {
+    if (const char *style = element->Attribute("style")) {
+        size_t nameLen = strlen(name);
+        for (const char *cur = style; *cur;) {
+            while (*cur == ' ' || *cur == '\t' || *cur == '\r' || *cur == '\n')
+                ++cur;
+            const char *end = strchr(cur, ';');
+            if (!end)
+                end = cur+strlen(cur);
+            const char *colon = (const char *) memchr(cur, ':', end-cur);
+            if (colon) {
+                const char *keyEnd = colon;
+                while (keyEnd > cur && (keyEnd[-1] == ' ' || keyEnd[-1] == '\t'))
+                    --keyEnd;
+                if (size_t(keyEnd-cur) == nameLen && !memcmp(cur, name, nameLen)) {
+                    std::string value;
+                    for (const char *c = colon+1; c < end; ++c)
+                        if (*c != ' ' && *c != '\t' && *c != '\r' && *c != '\n')
+                            value += *c;
+                    return value;
+                }
+            }
+            cur = *end ? end+1 : end;
+        }
+    }
+    const char *value = element->Attribute(name);
+    return value ? std::string(value) : std::string();
+}
+
+static void gatherSvgPaths(std::vector<SvgPath> &output, tinyxml2::XMLElement *parent, const std::string &transformation, double endpointSnapRange) {
+    for (tinyxml2::XMLElement *cur = parent->FirstChildElement(); cur; cur = cur->NextSiblingElement()) {
+        std::string curTransformation = transformation;
+        if (const char *transform = cur->Attribute("transform"))
+            curTransformation += (curTransformation.empty() ? "" : " ")+std::string(transform);
+        if (!strcmp(cur->Name(), "path")) {
+            output.push_back(SvgPath());
+            SvgPath &path = output.back();
+            path.fill = readStyleProperty(cur, "fill");
+            path.opacity = readStyleProperty(cur, "opacity");
+            path.transform = curTransformation;
+            path.shape.inverseYAxis = true;
+            const char *pd = cur->Attribute("d");
+            if (!(pd && buildShapeFromSvgPath(path.shape, pd, endpointSnapRange)))
+                path.shape.contours.clear();
+        } else if (!strcmp(cur->Name(), "g"))
+            gatherSvgPaths(output, cur, curTransformation, endpointSnapRange);
+    }
+}
+
+bool loadSvgShapes(std::vector<SvgPath> &output, const char *filename, Vector2 *dimensions) {
+    output.clear();
+    tinyxml2::XMLDocument doc;
+    if (doc.LoadFile(filename))
+        return false;
+    tinyxml2::XMLElement *root = doc.FirstChildElement("svg");
+    if (!root)
+        return false;
+
+    Vector2 dims(root->DoubleAttribute("width"), root->DoubleAttribute("height"));
+    if (const char *viewBox = root->Attribute("viewBox")) {
+        double left = 0, top = 0;
+        readDouble(left, viewBox) && readDouble(top, viewBox) && readDouble(dims.x, viewBox) && readDouble(dims.y, viewBox);
+    }
+    if (dimensions)
+        *dimensions = dims;
+    gatherSvgPaths(output, root, std::string(), ENDPOINT_SNAP_RANGE_PROPORTION*dims.length());
+    return true;
+}
+
 #ifndef MSDFGEN_USE_SKIA
 
 int loadSvgShape(Shape &output, Shape::Bounds &viewBox, const char *filename) {
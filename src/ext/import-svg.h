@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
 #include "../core/Shape.h"
 
 #ifndef MSDFGEN_DISABLE_SVG
@@ -24,6 +26,19 @@ bool buildShapeFromSvgPath(Shape &shape, const char *pathDef, double endpointSna
 /// Reads a single <path> element found in the specified SVG file and converts it to output Shape
 bool loadSvgShape(Shape &output, const char *filename, int pathIndex = 0, Vector2 *dimensions = NULL);
 
+/// A <path> element of an SVG file together with the attributes that style and place it
+struct SvgPath {
+    /// Empty if the path has no valid geometry
+    Shape shape;
+    /// The fill color and opacity as written in the element's attributes, or its style attribute which takes precedence. Empty if not set
+    std::string fill, opacity;
+    /// The transformations of the enclosing groups and the element itself, outermost first. Not applied to the shape
+    std::string transform;
+};
+
+/// Reads every <path> element of the specified SVG file in a single pass, in the order in which loadSvgShape counts them (output[i] is its pathIndex i+1)
+bool loadSvgShapes(std::vector<SvgPath> &output, const char *filename, Vector2 *dimensions = NULL);
+
 /// New version - if Skia is available, reads the entire geometry of the SVG file into the output Shape, otherwise may only read one path, returns SVG import flags
 int loadSvgShape(Shape &output, Shape::Bounds &viewBox, const char *filename);
 
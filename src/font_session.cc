@@ -0,0 +1,106 @@
+#include "font_session.h"
+
+#include <memory>
+
+#include "work_stealing.h"
+
+FontSession::FontSession(const std::string &fontPath) : fontPath(fontPath), ft(NULL), font(NULL), fontMetrics() {
+  ft = initializeFreetype();
+  if (!ft) return;
+  font = loadFont(ft, fontPath.c_str());
+  if (!font) {
+    close();
+    return;
+  }
+  getFontMetrics(fontMetrics, font);
+}
+
+FontSession::~FontSession() {
+  close();
+}
+
+bool FontSession::isOpen() const {
+  return font != NULL;
+}
+
+void FontSession::close() {
+  if (font) {
+    destroyFont(font);
+    font = NULL;
+  }
+  if (ft) {
+    deinitializeFreetype(ft);
+    ft = NULL;
+  }
+}
+
+const std::string &FontSession::path() const {
+  return fontPath;
+}
+
+const FontMetrics &FontSession::metrics() const {
+  return fontMetrics;
+}
+
+bool FontSession::buildGlyph(GlyphRender &result, unsigned code, bool codeIsIndex, float size, float range, SDFType type, bool packed) {
+  Shape shape;
+  if (!prepareGlyph(result, shape, code, codeIsIndex, size, range)) return false;
+  if (packed) result.channels = sdfTypeChannels(type);
+  result.data.resize(glyphByteLength(result));
+  generateShape(result.data.data(), result, shape, type);
+
+  return true;
+}
+
+bool FontSession::prepareGlyph(GlyphRender &result, Shape &shape, unsigned code, bool codeIsIndex, float size, float range) {
+  if (!font) return false;
+  // if code is index, directly setup, otherwise find index from unicode value
+  GlyphIndex glyphIndex;
+  if (codeIsIndex) glyphIndex = GlyphIndex(code);
+  else getGlyphIndex(glyphIndex, font, (unicode_t) code);
+
+  double advance = 0;
+  if (!loadGlyph(shape, font, glyphIndex, &advance)) return false;
+  if (!prepareShape(result, shape, fontMetrics.emSize, size, range)) return false;
+  result.lineHeight = lineHeight(size);
+  result.advance = advance;
+
+  return true;
+}
+
+bool FontSession::buildGlyphs(GlyphBatch &batch, const uint32_t *codes, const uint8_t *flags, size_t count, float size, float range, SDFType type, unsigned threads, size_t headerSize, bool packed, const std::function<void(size_t done)> &onGlyph, const GlyphCache *cache) {
+  std::vector<GlyphRender> &glyphs = batch.glyphs;
+  glyphs.clear();
+  glyphs.resize(count);
+  batch.offsets.assign(count, -1);
+  batch.headerSize = headerSize;
+  std::vector<Shape> shapes(count);
+  int channels = packed ? sdfTypeChannels(type) : 4;
+  batch.channels = channels;
+  threads = resolveThreadCount(threads, count);
+  // worker 0 runs on the calling thread and uses this session, the rest open their own lazily
+  std::vector<std::unique_ptr<FontSession>> sessions(threads);
+
+  // 1) load and lay out every glyph so the arena size is known up front
+  std::vector<char> prepared(count, 0);
+  parallelFor(count, threads, [&](unsigned worker, size_t i) {
+    FontSession *session = this;
+    if (worker > 0) {
+      if (!sessions[worker]) sessions[worker].reset(new FontSession(fontPath));
+      session = sessions[worker].get();
+    }
+    if (session->prepareGlyph(glyphs[i], shapes[i], codes[i], flags[i] & GLYPH_FLAG_INDEX, size, range)) prepared[i] = 1;
+    else glyphs[i] = GlyphRender();
+    glyphs[i].channels = channels;
+  });
+
+  // 2) allocate the arena and generate every glyph straight into its slot
+  return generateGlyphBatch(batch, shapes, prepared, type, threads, onGlyph, cache);
+}
+
+float FontSession::lineHeight(float size) const {
+  float lineHeight = fontMetrics.lineHeight;
+  float emSize = fontMetrics.emSize;
+  float scale = size / emSize;
+  return scale * lineHeight;
+}
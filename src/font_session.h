@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "glyph_render.h"
+
+/// Per-glyph flags of a batch render
+enum GlyphFlags {
+  /// the code is a glyph index rather than a unicode value
+  GLYPH_FLAG_INDEX = 1
+};
+
+/**
+ * Holds an open FreeType library, face and the face's metrics so that many glyphs can be
+ * rendered from one font without re-reading and re-parsing the font file for each of them.
+ * Not thread-safe: a FreeType face may only be used by one thread at a time.
+ */
+class FontSession {
+
+public:
+  explicit FontSession(const std::string &fontPath);
+  ~FontSession();
+  FontSession(const FontSession &) = delete;
+  FontSession &operator=(const FontSession &) = delete;
+
+  /// True if the font was loaded and the session has not been closed
+  bool isOpen() const;
+  /// Release the face and library. Safe to call more than once.
+  void close();
+  /// Path of the font this session was opened with
+  const std::string &path() const;
+  /// Metrics of the face in font units
+  const FontMetrics &metrics() const;
+  /// Load and render a glyph by unicode value, or by glyph index if codeIsIndex is set.
+  /// Pixels are RGBA unless packed is set, in which case only the type's own channels are kept.
+  bool buildGlyph(GlyphRender &result, unsigned code, bool codeIsIndex, float size, float range, SDFType type, bool packed = false);
+  /// Load and lay out a glyph (see prepareShape) without rendering its pixels
+  bool prepareGlyph(GlyphRender &result, Shape &shape, unsigned code, bool codeIsIndex, float size, float range);
+  /**
+   * Render every code in order into one arena. All glyphs are laid out first so the arena is
+   * allocated once and every glyph is generated straight into its slot, leaving headerSize
+   * bytes in front of each for the caller. Glyphs that fail are left empty (zero size).
+   * With more than one thread (0 = one per core) the work is spread over a work-stealing pool;
+   * every extra worker opens its own face since a face can not be shared between threads.
+   * Pixels are RGBA unless packed is set, in which case only the type's own channels are kept.
+   * onGlyph, if set, is called from the rendering thread with the number of finished glyphs.
+   * Glyphs found in cache, if set, are copied from it instead of rendered (see GlyphCache).
+   * Returns false if the batch is too large for one arena (see generateGlyphBatch).
+   */
+  bool buildGlyphs(GlyphBatch &batch, const uint32_t *codes, const uint8_t *flags, size_t count, float size, float range, SDFType type, unsigned threads = 1, size_t headerSize = 0, bool packed = false, const std::function<void(size_t done)> &onGlyph = nullptr, const GlyphCache *cache = nullptr);
+  /// Line height of the face scaled to the given pixel size
+  float lineHeight(float size) const;
+
+private:
+  std::string fontPath;
+  FreetypeHandle *ft;
+  FontHandle *font;
+  FontMetrics fontMetrics;
+
+};
@@ -0,0 +1,121 @@
+#include "glyph_cache.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#ifdef _WIN32
+#include <sys/utime.h>
+#define utime _utime
+#else
+#include <utime.h>
+#endif
+
+// bump whenever the generators change their output, so stale entries stop matching. Cached renders
+// always use generateShape's default search modes, so those need no key of their own
+#define GLYPH_CACHE_VERSION 3
+#define GLYPH_CACHE_EXTENSION ".sdf"
+
+namespace {
+
+/// Two independent 64 bit lanes (FNV-1a and a multiply-xorshift mix) for a 128 bit key
+class KeyHasher {
+
+public:
+  KeyHasher() : a(0xcbf29ce484222325ull), b(0x9e3779b97f4a7c15ull) {}
+
+  void add(uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+      a ^= (value >> (i * 8)) & 0xff;
+      a *= 0x100000001b3ull;
+    }
+    b ^= value + 0x9e3779b97f4a7c15ull + (b << 6) + (b >> 2);
+    b ^= b >> 31;
+    b *= 0xbf58476d1ce4e5b9ull;
+  }
+
+  void add(double value) {
+    // +0 and -0 render the same
+    if (value == 0) value = 0;
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    add(bits);
+  }
+
+  void add(const Vector2 &vector) {
+    add(vector.x);
+    add(vector.y);
+  }
+
+  std::string hex() const {
+    char str[33];
+    snprintf(str, sizeof(str), "%016llx%016llx", (unsigned long long) a, (unsigned long long) b);
+    return str;
+  }
+
+private:
+  uint64_t a, b;
+
+};
+
+}
+
+GlyphCache::GlyphCache(const std::string &directory) : directory(directory) {}
+
+bool GlyphCache::enabled() const {
+  return !directory.empty();
+}
+
+std::string GlyphCache::key(const Shape &shape, const GlyphRender &glyph, SDFType type) {
+  KeyHasher hasher;
+  hasher.add((uint64_t) GLYPH_CACHE_VERSION);
+  hasher.add((uint64_t) type);
+  hasher.add((uint64_t) glyph.channels);
+  hasher.add((uint64_t) glyph.width);
+  hasher.add((uint64_t) glyph.height);
+  // the projection's scale and the image of the origin pin down its translation too
+  hasher.add(glyph.projection.projectVector(Vector2(1)));
+  hasher.add(glyph.projection.project(Point2(0)));
+  hasher.add(glyph.shapeRange);
+  hasher.add((uint64_t) shape.inverseYAxis);
+  hasher.add((uint64_t) shape.contours.size());
+  for (const Contour &contour : shape.contours) {
+    hasher.add((uint64_t) contour.edges.size());
+    for (const EdgeHolder &edge : contour.edges) {
+      int edgeType = edge->type();
+      hasher.add((uint64_t) edgeType);
+      hasher.add((uint64_t) edge->color);
+      // a segment of type n has n + 1 control points
+      const Point2 *points = edge->controlPoints();
+      for (int i = 0; i <= edgeType; i++) hasher.add(points[i]);
+    }
+  }
+  return hasher.hex();
+}
+
+std::string GlyphCache::entryPath(const std::string &key) const {
+  return directory + "/" + key + GLYPH_CACHE_EXTENSION;
+}
+
+bool GlyphCache::load(const std::string &key, byte *pixels, size_t length) const {
+  if (!enabled()) return false;
+  std::string path = entryPath(key);
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file) return false;
+  bool ok = fread(pixels, 1, length, file) == length && fgetc(file) == EOF;
+  fclose(file);
+  if (ok) utime(path.c_str(), NULL);
+  return ok;
+}
+
+void GlyphCache::store(const std::string &key, const byte *pixels, size_t length) const {
+  if (!enabled()) return;
+  static std::atomic<uint64_t> counter(std::random_device{}());
+  std::string path = entryPath(key);
+  std::string tmpPath = path + "." + std::to_string(counter++) + ".tmp";
+  FILE *file = fopen(tmpPath.c_str(), "wb");
+  if (!file) return;
+  bool ok = fwrite(pixels, 1, length, file) == length;
+  ok = fclose(file) == 0 && ok;
+  if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0) remove(tmpPath.c_str());
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "glyph_render.h"
+
+/**
+ * An on-disk cache of rendered glyph pixels, one file per glyph named by a hash of everything
+ * that decides its pixels: the prepared shape's geometry and edge colors, the glyph's layout,
+ * the SDF type and the channel count. Renders of the same outline with the same parameters hit
+ * no matter which font, code point or build they came from.
+ * Entries are written to a temporary file and renamed into place, so workers and processes may
+ * share a directory. A hit refreshes the entry's modification time, so evicting the oldest
+ * entries (pruneGlyphCache on the JS side) drops the least recently used ones first.
+ */
+class GlyphCache {
+
+public:
+  /// directory must exist; a cache whose directory is empty does nothing
+  explicit GlyphCache(const std::string &directory);
+
+  /// False if no directory was given
+  bool enabled() const;
+  /// Key of a prepared glyph (see prepareShape) rendered as type with glyph.channels channels
+  static std::string key(const Shape &shape, const GlyphRender &glyph, SDFType type);
+  /// Copy a cached render into pixels. Fails unless the entry exists and is exactly length bytes.
+  bool load(const std::string &key, byte *pixels, size_t length) const;
+  /// Save a render. Failures are ignored, the glyph is just rendered again next time.
+  void store(const std::string &key, const byte *pixels, size_t length) const;
+
+private:
+  std::string directory;
+
+  std::string entryPath(const std::string &key) const;
+
+};
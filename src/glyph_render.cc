@@ -0,0 +1,178 @@
+#include "glyph_render.h"
+
+#include <atomic>
+#include <cmath>
+
+#include "glyph_cache.h"
+#include "work_stealing.h"
+
+// pixels times edges below which brute force beats building a ShapeEdgeGrid
+#define EDGE_GRID_MIN_WORK (1 << 17)
+
+SDFType parseSDFType(const std::string &type) {
+  if (type == "mtsdf") return SDF_TYPE_MTSDF;
+  if (type == "msdf") return SDF_TYPE_MSDF;
+  if (type == "psdf") return SDF_TYPE_PSDF;
+  return SDF_TYPE_SDF;
+}
+
+int sdfTypeChannels(SDFType type) {
+  if (type == SDF_TYPE_MTSDF) return 4;
+  if (type == SDF_TYPE_MSDF) return 3;
+  return 1;
+}
+
+bool prepareShape(
+  GlyphRender &result,
+  Shape &shape,
+  float emSize,
+  float size,
+  float range
+) {
+  // empty shapes (e.g. whitespace) have no bounds to render
+  if (shape.edgeCount() == 0) return false;
+  shape.normalize();
+  if (!resolveShapeGeometry(shape)) return false;
+  edgeColoringByDistance(shape, 3., 0.);
+  // grab data
+  result.shapeSize = shape.contours.size();
+  // build scale
+  float scale = size / emSize;
+  // update range by scale
+  range = 0.5 * range / scale;
+  // prep data
+  Shape::Bounds bounds = shape.getBounds(range);
+  // Calculate width & height
+  result.width = ceil(scale * (bounds.r - bounds.l));
+  result.height = ceil(scale * (bounds.t - bounds.b));
+  result.projection = Projection(scale, Vector2(-bounds.l, -bounds.b));
+  result.shapeRange = range * 2.;
+
+  result.emSize = scale * emSize;
+  // bounds
+  result.r = scale * bounds.r;
+  result.l = scale * bounds.l;
+  result.t = scale * bounds.t;
+  result.b = scale * bounds.b;
+
+  return true;
+}
+
+size_t glyphByteLength(const GlyphRender &glyph) {
+  return glyph.channels * (size_t) glyph.width * glyph.height;
+}
+
+void generateShape(byte *pixels, const GlyphRender &glyph, const Shape &shape, SDFType type, bool quadraticSearchHints) {
+  int width = glyph.width;
+  int height = glyph.height;
+  int channels = glyph.channels;
+  const Projection &projection = glyph.projection;
+  double range = glyph.shapeRange;
+  // cull the edges each pixel visits (same output as visiting them all), once the bitmap and
+  // edge count are large enough for the per-cell edge lists to pay for themselves. For sdf, the
+  // same grid finds the blocks of pixels too far from the shape to be anything but 0 or 255 once
+  // quantized, which only need the sign of one distance per row of the block
+  MSDFGeneratorConfig config;
+  config.edgeGrid = (size_t) width * height * shape.edgeCount() >= EDGE_GRID_MIN_WORK;
+  config.skipFarField = config.edgeGrid;
+  config.quadraticSearchHints = quadraticSearchHints;
+
+  // depending upon type, build
+  if (type == SDF_TYPE_MTSDF) {
+    Bitmap<float, 4> mtsdf(width, height);
+    generateMTSDF(mtsdf, shape, projection, range, config);
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        size_t idx = (width * y + x) << 2;
+        pixels[idx] = pixelFloatToByte(mtsdf(x, y)[0]);
+        pixels[idx + 1] = pixelFloatToByte(mtsdf(x, y)[1]);
+        pixels[idx + 2] = pixelFloatToByte(mtsdf(x, y)[2]);
+        pixels[idx + 3] = pixelFloatToByte(mtsdf(x, y)[3]);
+      }
+    }
+  } else if (type == SDF_TYPE_MSDF) {
+    Bitmap<float, 3> msdf(width, height);
+    generateMSDF(msdf, shape, projection, range, config);
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        size_t idx = (size_t) (width * y + x) * channels;
+        pixels[idx] = pixelFloatToByte(msdf(x, y)[0]);
+        pixels[idx + 1] = pixelFloatToByte(msdf(x, y)[1]);
+        pixels[idx + 2] = pixelFloatToByte(msdf(x, y)[2]);
+        if (channels == 4) pixels[idx + 3] = 255;
+      }
+    }
+  } else {
+    // quantize straight into the front of the output, no float bitmap needed
+    BitmapRef<byte, 1> sdf(pixels, width, height);
+    if (type == SDF_TYPE_PSDF) generatePseudoSDF(sdf, shape, projection, range, config);
+    else generateSDF(sdf, shape, projection, range, config);
+    if (channels == 1) return;
+    // expand to RGBA in place, back to front so no pixel is overwritten before it is read
+    for (size_t i = (size_t) width * height; i-- > 0;) {
+      byte pixel = pixels[i];
+      size_t idx = i << 2;
+      pixels[idx] = pixel;
+      pixels[idx + 1] = pixel;
+      pixels[idx + 2] = pixel;
+      pixels[idx + 3] = 255;
+    }
+  }
+}
+
+bool renderShape(
+  GlyphRender &result,
+  Shape &shape,
+  float emSize,
+  float size,
+  float range,
+  SDFType type
+) {
+  if (!prepareShape(result, shape, emSize, size, range)) return false;
+  result.data.resize(glyphByteLength(result));
+  generateShape(result.data.data(), result, shape, type);
+
+  return true;
+}
+
+bool generateGlyphBatch(
+  GlyphBatch &batch,
+  std::vector<Shape> &shapes,
+  const std::vector<char> &prepared,
+  SDFType type,
+  unsigned threads,
+  const std::function<void(size_t done)> &onGlyph,
+  const GlyphCache *cache
+) {
+  size_t count = batch.glyphs.size();
+  // one allocation for the whole batch
+  size_t total = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (!prepared[i]) continue;
+    total += batch.headerSize;
+    batch.offsets[i] = total;
+    total += glyphByteLength(batch.glyphs[i]);
+  }
+  if (total > (size_t) INT32_MAX) {
+    batch.offsets.assign(count, -1);
+    return false;
+  }
+  batch.arena.assign(total, 0);
+
+  std::atomic<size_t> done(0);
+  parallelFor(count, threads, [&](unsigned /*worker*/, size_t i) {
+    if (prepared[i]) {
+      byte *pixels = batch.arena.data() + batch.offsets[i];
+      size_t length = glyphByteLength(batch.glyphs[i]);
+      std::string key;
+      if (cache && cache->enabled()) key = GlyphCache::key(shapes[i], batch.glyphs[i], type);
+      if (key.empty() || !cache->load(key, pixels, length)) {
+        generateShape(pixels, batch.glyphs[i], shapes[i], type);
+        if (!key.empty()) cache->store(key, pixels, length);
+      }
+      std::vector<Contour>().swap(shapes[i].contours);
+    }
+    if (onGlyph) onGlyph(++done);
+  });
+  return true;
+}
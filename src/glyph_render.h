@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "msdfgen.h"
+#include "msdfgen-ext.h"
+
+using namespace msdfgen;
+
+class GlyphCache;
+
+/// The distance field flavours the binding can produce
+enum SDFType {
+  SDF_TYPE_SDF,
+  SDF_TYPE_PSDF,
+  SDF_TYPE_MSDF,
+  SDF_TYPE_MTSDF
+};
+
+/// Parse the JS type string ('sdf' | 'psdf' | 'msdf' | 'mtsdf'). Unknown values fall back to sdf.
+SDFType parseSDFType(const std::string &type);
+
+/// Number of channels a type carries: 1 for sdf/psdf, 3 for msdf, 4 for mtsdf
+int sdfTypeChannels(SDFType type);
+
+/// A rendered glyph: pixel data plus its metrics already scaled to pixel space
+struct GlyphRender {
+  std::vector<byte> data;
+  /// channels per pixel in data: 4 (RGBA, padded) or the type's own sdfTypeChannels
+  int channels = 4;
+  /// shape space to pixel space transform and the distance range in shape units, set by prepareShape
+  Projection projection;
+  double shapeRange = 0;
+  int width = 0;
+  int height = 0;
+  int shapeSize = 0;
+  double emSize = 0;
+  double lineHeight = 0;
+  double l = 0;
+  double r = 0;
+  double t = 0;
+  double b = 0;
+  double advance = 0;
+};
+
+/// A batch of glyphs rendered into one pixel arena
+struct GlyphBatch {
+  /// metrics of every glyph; their own data stays empty
+  std::vector<GlyphRender> glyphs;
+  /// byte offset of each glyph's pixels in the arena, -1 if the glyph failed
+  std::vector<int64_t> offsets;
+  /// every glyph's pixels, each preceded by headerSize reserved bytes
+  std::vector<byte> arena;
+  size_t headerSize = 0;
+  /// channels per pixel of every glyph in the arena
+  int channels = 4;
+};
+
+/**
+ * Normalize, resolve and edge-color the shape and lay it out: fills in the glyph's pixel size,
+ * bounds and projection without generating any pixels.
+ * Returns false if the shape is empty or its geometry could not be resolved.
+ */
+bool prepareShape(
+  GlyphRender &result,
+  Shape &shape,
+  float emSize,
+  float size,
+  float range
+);
+
+/// Number of bytes generateShape writes for a prepared glyph
+size_t glyphByteLength(const GlyphRender &glyph);
+
+/// Render a prepared shape as the requested SDF type into `pixels` (glyphByteLength bytes, glyph.channels per pixel).
+/// See GeneratorConfig for quadraticSearchHints
+void generateShape(byte *pixels, const GlyphRender &glyph, const Shape &shape, SDFType type, bool quadraticSearchHints = true);
+
+/**
+ * Normalize, resolve and edge-color the shape, then render it as the requested SDF type.
+ * emSize is the em size of the shape's coordinate space (font units or SVG height).
+ * Returns false if the shape's geometry could not be resolved.
+ */
+bool renderShape(
+  GlyphRender &result,
+  Shape &shape,
+  float emSize,
+  float size,
+  float range,
+  SDFType type
+);
+
+/**
+ * Finish a batch whose glyphs are already laid out (see prepareShape), prepared[i] marking the
+ * ones that succeeded: allocate the arena once, leaving batch.headerSize bytes in front of each
+ * glyph, then generate every shape straight into its slot on `threads` workers, releasing each
+ * shape once rendered. Glyphs found in cache, if set, are copied instead of generated and the
+ * rest are added to it. onGlyph, if set, is called from the rendering thread with the number of
+ * finished glyphs. Returns false, generating nothing, if the arena would reach 2 GB: offsets are
+ * handed to JS as int32.
+ */
+bool generateGlyphBatch(
+  GlyphBatch &batch,
+  std::vector<Shape> &shapes,
+  const std::vector<char> &prepared,
+  SDFType type,
+  unsigned threads,
+  const std::function<void(size_t done)> &onGlyph = nullptr,
+  const GlyphCache *cache = nullptr
+);
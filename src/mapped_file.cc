@@ -0,0 +1,69 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string &path) : mapping(nullptr), length(0), file(INVALID_HANDLE_VALUE), view(nullptr) {
+  file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) return;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) return;
+  mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping) return;
+  view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (view) length = (size_t) size.QuadPart;
+}
+
+MappedFile::~MappedFile() {
+  if (view) UnmapViewOfFile(view);
+  if (mapping) CloseHandle(mapping);
+  if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+}
+
+const unsigned char *MappedFile::data() const {
+  return (const unsigned char *) view;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &path) : mapping(nullptr), length(0) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return;
+  struct stat st;
+  // an empty file can not be mapped
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    void *address = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (address != MAP_FAILED) {
+      mapping = address;
+      length = (size_t) st.st_size;
+    }
+  }
+  // the mapping keeps the file alive on its own
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (mapping) munmap(mapping, length);
+}
+
+const unsigned char *MappedFile::data() const {
+  return (const unsigned char *) mapping;
+}
+
+#endif
+
+bool MappedFile::isOpen() const {
+  return length > 0;
+}
+
+size_t MappedFile::size() const {
+  return length;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * A file mapped read-only into memory. The pages are loaded by the OS as they are touched and
+ * shared with every other process mapping the same file, so opening is O(1) whatever the size.
+ */
+class MappedFile {
+
+public:
+  explicit MappedFile(const std::string &path);
+  ~MappedFile();
+
+  bool isOpen() const;
+  const unsigned char *data() const;
+  size_t size() const;
+
+private:
+  void *mapping;
+  size_t length;
+#ifdef _WIN32
+  void *file;
+  void *view;
+#endif
+
+  MappedFile(const MappedFile &);
+  MappedFile &operator=(const MappedFile &);
+
+};
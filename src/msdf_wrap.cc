@@ -1,15 +1,231 @@
 #include <napi.h>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <memory>
 #include <string>
-#include <cstring>
+#include <vector>
 
 #include "msdfgen.h"
 #include "msdfgen-ext.h"
+#include "atlas_packer.h"
+#include "font_session.h"
+#include "glyph_cache.h"
+#include "mapped_file.h"
+#include "svg_document.h"
+#include "glyph_render.h"
 
 using namespace msdfgen;
 using namespace Napi;
 
 // https://github.com/Chlumsky/msdfgen
 
+/**
+ *
+ *
+ *
+ * GLYPH OBJECT
+ *
+ *
+ *
+**/
+
+Napi::Object glyphToObject(Napi::Env env, GlyphRender &glyph, bool includeLineHeight) {
+  Napi::Object obj = Napi::Object::New(env);
+  // hand the pixel storage over to the ArrayBuffer; it is released when the buffer is collected
+  if (glyph.data.empty()) {
+    obj.Set(Napi::String::New(env, "data"), Napi::ArrayBuffer::New(env, 0));
+  } else {
+    std::vector<byte> *pixels = new std::vector<byte>(std::move(glyph.data));
+    obj.Set(Napi::String::New(env, "data"), Napi::ArrayBuffer::New(env, pixels->data(), pixels->size(), [](Env /*env*/, void* /*data*/, std::vector<byte> *hint) {
+      delete hint;
+    }, pixels));
+  }
+  obj.Set(Napi::String::New(env, "width"), Napi::Number::New(env, glyph.width));
+  obj.Set(Napi::String::New(env, "height"), Napi::Number::New(env, glyph.height));
+  obj.Set(Napi::String::New(env, "channels"), Napi::Number::New(env, glyph.channels));
+  obj.Set(Napi::String::New(env, "shapeSize"), Napi::Number::New(env, glyph.shapeSize));
+  if (includeLineHeight) obj.Set(Napi::String::New(env, "lineHeight"), Napi::Number::New(env, glyph.lineHeight));
+  obj.Set(Napi::String::New(env, "emSize"), Napi::Number::New(env, glyph.emSize));
+  // bounds
+  obj.Set(Napi::String::New(env, "r"), Napi::Number::New(env, glyph.r));
+  obj.Set(Napi::String::New(env, "l"), Napi::Number::New(env, glyph.l));
+  obj.Set(Napi::String::New(env, "t"), Napi::Number::New(env, glyph.t));
+  obj.Set(Napi::String::New(env, "b"), Napi::Number::New(env, glyph.b));
+  // advance
+  obj.Set(Napi::String::New(env, "advance"), Napi::Number::New(env, glyph.advance));
+
+  return obj;
+}
+
+// sizes (Int32Array) stride: width, height, byte offset of the pixels in data (-1 if the glyph failed), byte length
+#define GLYPH_BATCH_SIZES 4
+// metrics (Float64Array) stride: emSize, l, r, t, b, advance
+#define GLYPH_BATCH_METRICS 6
+// the offsets in sizes are int32, so an arena must stay below 2 GB (see generateGlyphBatch)
+#define GLYPH_BATCH_TOO_LARGE "Glyph batch exceeds 2 GB, split it into smaller batches"
+
+Napi::Object glyphsToObject(Napi::Env env, GlyphBatch &batch, double lineHeight) {
+  Napi::Object obj = Napi::Object::New(env);
+  size_t count = batch.glyphs.size();
+  Napi::Int32Array sizes = Napi::Int32Array::New(env, count * GLYPH_BATCH_SIZES);
+  Napi::Float64Array metrics = Napi::Float64Array::New(env, count * GLYPH_BATCH_METRICS);
+  for (size_t i = 0; i < count; i++) {
+    const GlyphRender &glyph = batch.glyphs[i];
+    int32_t *size = sizes.Data() + i * GLYPH_BATCH_SIZES;
+    double *metric = metrics.Data() + i * GLYPH_BATCH_METRICS;
+    size[0] = glyph.width;
+    size[1] = glyph.height;
+    size[2] = (int32_t) batch.offsets[i];
+    size[3] = batch.offsets[i] < 0 ? 0 : (int32_t) glyphByteLength(glyph);
+    metric[0] = glyph.emSize;
+    metric[1] = glyph.l;
+    metric[2] = glyph.r;
+    metric[3] = glyph.t;
+    metric[4] = glyph.b;
+    metric[5] = glyph.advance;
+  }
+  // hand the arena over to JS as is; it is released when the buffer is collected
+  if (batch.arena.empty()) {
+    obj.Set(Napi::String::New(env, "data"), Napi::ArrayBuffer::New(env, 0));
+  } else {
+    std::vector<byte> *arena = new std::vector<byte>(std::move(batch.arena));
+    obj.Set(Napi::String::New(env, "data"), Napi::ArrayBuffer::New(env, arena->data(), arena->size(), [](Env /*env*/, void* /*data*/, std::vector<byte> *hint) {
+      delete hint;
+    }, arena));
+  }
+  obj.Set(Napi::String::New(env, "sizes"), sizes);
+  obj.Set(Napi::String::New(env, "metrics"), metrics);
+  obj.Set(Napi::String::New(env, "channels"), Napi::Number::New(env, batch.channels));
+  obj.Set(Napi::String::New(env, "lineHeight"), Napi::Number::New(env, lineHeight));
+
+  return obj;
+}
+
+// validate (size, range, type, threads?, headerSize?, packed?) starting at argument `first`
+bool checkBatchOptionArgs(const Napi::CallbackInfo& info, size_t first) {
+  Napi::Env env = info.Env();
+  if (!info[first].IsNumber()) {
+    Napi::Error::New(env, "Expected size to be a number")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+  if (!info[first + 1].IsNumber()) {
+    Napi::Error::New(env, "Expected range to be a number")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+  if (!info[first + 2].IsString()) {
+    Napi::Error::New(env, "Expected type to be a string")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+  if (info.Length() > first + 3 && !info[first + 3].IsUndefined() && !info[first + 3].IsNumber()) {
+    Napi::Error::New(env, "Expected threads to be a number")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+  if (info.Length() > first + 4 && !info[first + 4].IsUndefined() && !info[first + 4].IsNumber()) {
+    Napi::Error::New(env, "Expected headerSize to be a number")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+  if (info.Length() > first + 5 && !info[first + 5].IsUndefined() && !info[first + 5].IsBoolean()) {
+    Napi::Error::New(env, "Expected packed to be a boolean")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+  return true;
+}
+
+// validate (codes, flags, size, range, type, threads?, headerSize?, packed?) starting at argument `first`
+bool checkGlyphBatchArgs(const Napi::CallbackInfo& info, size_t first) {
+  Napi::Env env = info.Env();
+  if (!info[first].IsTypedArray() || info[first].As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array) {
+    Napi::Error::New(env, "Expected codes to be a Uint32Array")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+  if (!info[first + 1].IsTypedArray() || info[first + 1].As<Napi::TypedArray>().TypedArrayType() != napi_uint8_array) {
+    Napi::Error::New(env, "Expected flags to be a Uint8Array")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+  if (info[first].As<Napi::Uint32Array>().ElementLength() != info[first + 1].As<Napi::Uint8Array>().ElementLength()) {
+    Napi::Error::New(env, "Expected codes and flags to have the same length")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+  return checkBatchOptionArgs(info, first + 2);
+}
+
+// validate (pathIndices, size, range, type, threads?, headerSize?, packed?) starting at argument `first`
+bool checkSVGBatchArgs(const Napi::CallbackInfo& info, size_t first) {
+  if (!info[first].IsTypedArray() || info[first].As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array) {
+    Napi::Error::New(info.Env(), "Expected pathIndices to be a Uint32Array")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+  return checkBatchOptionArgs(info, first + 1);
+}
+
+// validate the optional cacheDir argument at `index`
+bool checkCacheDirArg(const Napi::CallbackInfo& info, size_t index) {
+  if (info.Length() > index && !info[index].IsUndefined() && !info[index].IsString()) {
+    Napi::Error::New(info.Env(), "Expected cacheDir to be a string")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+  return true;
+}
+
+// directory of the render cache, empty (no cache) if the argument is not given
+std::string readCacheDir(const Napi::CallbackInfo& info, size_t index) {
+  return info.Length() > index && info[index].IsString() ? info[index].As<Napi::String>().Utf8Value() : std::string();
+}
+
+/// The rendering options every batch call shares, as validated by checkBatchOptionArgs
+struct BatchOptions {
+  float size;
+  float range;
+  SDFType type;
+  // 0 = one worker per core
+  unsigned threads;
+  // bytes reserved in front of every glyph so the caller can write its header in place
+  size_t headerSize;
+  // keep only the type's own channels instead of RGBA
+  bool packed;
+};
+
+BatchOptions readBatchOptions(const Napi::CallbackInfo& info, size_t first) {
+  BatchOptions options;
+  options.size = info[first].As<Napi::Number>().FloatValue();
+  options.range = info[first + 1].As<Napi::Number>().FloatValue();
+  options.type = parseSDFType(info[first + 2].As<Napi::String>().Utf8Value());
+  options.threads = info.Length() > first + 3 && info[first + 3].IsNumber() ? info[first + 3].As<Napi::Number>().Uint32Value() : 0;
+  options.headerSize = info.Length() > first + 4 && info[first + 4].IsNumber() ? info[first + 4].As<Napi::Number>().Uint32Value() : 0;
+  options.packed = info.Length() > first + 5 && info[first + 5].IsBoolean() && info[first + 5].As<Napi::Boolean>().Value();
+  return options;
+}
+
+// render the batch described by the arguments starting at `first` (see checkGlyphBatchArgs), plus cacheDir?
+Napi::Object buildGlyphBatch(const Napi::CallbackInfo& info, size_t first, FontSession &session) {
+  Napi::Env env = info.Env();
+  Napi::Uint32Array codes = info[first].As<Napi::Uint32Array>();
+  Napi::Uint8Array flags = info[first + 1].As<Napi::Uint8Array>();
+  BatchOptions options = readBatchOptions(info, first + 2);
+  GlyphCache cache(readCacheDir(info, first + 8));
+
+  GlyphBatch batch;
+  if (!session.buildGlyphs(batch, codes.Data(), flags.Data(), codes.ElementLength(), options.size, options.range, options.type, options.threads, options.headerSize, options.packed, nullptr, &cache)) {
+    Napi::Error::New(env, GLYPH_BATCH_TOO_LARGE)
+        .ThrowAsJavaScriptException();
+    return Napi::Object::New(env);
+  }
+
+  return glyphsToObject(env, batch, session.lineHeight(options.size));
+}
+
 /**
  *
  *
@@ -25,8 +241,8 @@ Napi::Object buildFontGlyph(const Napi::CallbackInfo& info) {
   // create object
   Napi::Object obj = Napi::Object::New(env);
   // check input
-  if (info.Length() != 6) {
-    Napi::Error::New(env, "Expected six arguments (fontPath, code, size, range, type, codeIsIndex)")
+  if (info.Length() != 6 && info.Length() != 7) {
+    Napi::Error::New(env, "Expected six or seven arguments (fontPath, code, size, range, type, codeIsIndex, packed?)")
         .ThrowAsJavaScriptException();
     return obj;
   }
@@ -56,7 +272,12 @@ Napi::Object buildFontGlyph(const Napi::CallbackInfo& info) {
     return obj;
   }
   if (!info[5].IsBoolean()) {
-    Napi::Error::New(env, "Expected the sixth argument to be a number (codeIsIndex)")
+    Napi::Error::New(env, "Expected the sixth argument to be a boolean (codeIsIndex)")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+  if (info.Length() > 6 && !info[6].IsUndefined() && !info[6].IsBoolean()) {
+    Napi::Error::New(env, "Expected the seventh argument to be a boolean (packed)")
         .ThrowAsJavaScriptException();
     return obj;
   }
@@ -68,144 +289,182 @@ Napi::Object buildFontGlyph(const Napi::CallbackInfo& info) {
   float range = info[3].As<Napi::Number>().FloatValue();
   std::string type = info[4].As<Napi::String>().Utf8Value();
   bool code_is_index = info[5].As<Napi::Boolean>().Value();
-
-  char font_path_arr[font_path.size() + 1];
-  strcpy(font_path_arr, font_path.c_str());
+  bool packed = info.Length() > 6 && info[6].IsBoolean() && info[6].As<Napi::Boolean>().Value();
 
   // https://github.com/Chlumsky/msdfgen/issues/117
 
-  GlyphIndex glyphIndex;
-  double advance = 0;
-
-  FreetypeHandle *ft = initializeFreetype();
-  if (ft) {
-    FontHandle *font = loadFont(ft, font_path_arr);
-    FontMetrics font_metrics;
-    if (font) {
-      getFontMetrics(font_metrics, font);
-
-      Shape shape;
-      // if code is index, directly setup, otherwise find index from unicode value
-      if (code_is_index) glyphIndex = GlyphIndex(code);
-      else getGlyphIndex(glyphIndex, font, (unicode_t) code);
-      if (loadGlyph(shape, font, glyphIndex, &advance)) {
-        shape.normalize();
-        if (resolveShapeGeometry(shape)) {
-          edgeColoringByDistance(shape, 3., 0.);
-          // grab data
-          int shape_size = shape.contours.size();
-          float lineHeight = font_metrics.lineHeight;
-          float emSize = font_metrics.emSize;
-          // build scale
-          float scale = size / emSize;
-          // update range by scale
-          range = 0.5 * range / scale;
-          // prep data
-          // Shape::Bounds actual_bounds = shape.getBounds(0);
-          Shape::Bounds bounds = shape.getBounds(range);
-          // Calculate width & height
-          int glyph_width = ceil(scale * (bounds.r - bounds.l));
-          int glyph_height = ceil(scale * (bounds.t - bounds.b));
-          // store the msdf in a byte array
-          byte *data;
-
-          int length, width, height;
-
-          // depending upon type, build
-          if (strcmp(type.c_str(), "mtsdf") == 0) {
-            Bitmap<float, 4> mtsdf(glyph_width, glyph_height);
-            generateMTSDF(mtsdf, shape, range * 2., scale, Vector2(-bounds.l, -bounds.b));
-            width = mtsdf.width();
-            height = mtsdf.height();
-            length = 4 * width * height;
-            data = new byte[length];
-            for (int y = 0; y < height; y++) {
-              for (int x = 0; x < width; x++) {
-                size_t idx = (width * y + x) << 2;
-                data[idx] = pixelFloatToByte(mtsdf(x, y)[0]);
-                data[idx + 1] = pixelFloatToByte(mtsdf(x, y)[1]);
-                data[idx + 2] = pixelFloatToByte(mtsdf(x, y)[2]);
-                data[idx + 3] = pixelFloatToByte(mtsdf(x, y)[3]);
-              }
-            }
-          } else if (strcmp(type.c_str(), "msdf") == 0) {
-            Bitmap<float, 3> msdf(glyph_width, glyph_height);
-            generateMSDF(msdf, shape, range * 2., scale, Vector2(-bounds.l, -bounds.b));
-            width = msdf.width();
-            height = msdf.height();
-            length = 4 * width * height;
-            data = new byte[length];
-            for (int y = 0; y < height; y++) {
-              for (int x = 0; x < width; x++) {
-                size_t idx = (width * y + x) << 2;
-                data[idx] = pixelFloatToByte(msdf(x, y)[0]);
-                data[idx + 1] = pixelFloatToByte(msdf(x, y)[1]);
-                data[idx + 2] = pixelFloatToByte(msdf(x, y)[2]);
-                data[idx + 3] = 255;
-              }
-            }
-          } else if (strcmp(type.c_str(), "psdf") == 0) {
-            Bitmap<float, 1> psdf(glyph_width, glyph_height);
-            generatePseudoSDF(psdf, shape, range * 2., scale, Vector2(-bounds.l, -bounds.b));
-            width = psdf.width();
-            height = psdf.height();
-            length = 4 * width * height;
-            data = new byte[length];
-            for (int y = 0; y < height; y++) {
-              for (int x = 0; x < width; x++) {
-                size_t idx = (width * y + x) << 2;
-                auto pixel = pixelFloatToByte(psdf(x, y)[0]);
-                data[idx] = pixel;
-                data[idx + 1] = pixel;
-                data[idx + 2] = pixel;
-                data[idx + 3] = 255;
-              }
-            }
-          } else {
-            // sdf
-            Bitmap<float, 1> msdf(glyph_width, glyph_height);
-            generateSDF(msdf, shape, range * 2., scale, Vector2(-bounds.l, -bounds.b));
-            width = msdf.width();
-            height = msdf.height();
-            length = 4 * width * height;
-            data = new byte[length];
-            for (int y = 0; y < height; y++) {
-              for (int x = 0; x < width; x++) {
-                size_t idx = (width * y + x) << 2;
-                auto pixel = pixelFloatToByte(msdf(x, y)[0]);
-                data[idx] = pixel;
-                data[idx + 1] = pixel;
-                data[idx + 2] = pixel;
-                data[idx + 3] = 255;
-              }
-            }
-          }
-
-          obj.Set(Napi::String::New(env, "data"), Napi::ArrayBuffer::New(env, data, length, [](Env /*env*/, void* finalizeData) {
-            free(finalizeData);
-          }));
-          obj.Set(Napi::String::New(env, "width"), Napi::Number::New(env, width));
-          obj.Set(Napi::String::New(env, "height"), Napi::Number::New(env, height));
-          obj.Set(Napi::String::New(env, "shapeSize"), Napi::Number::New(env, shape_size));
-          obj.Set(Napi::String::New(env, "lineHeight"), Napi::Number::New(env, scale * lineHeight));
-          obj.Set(Napi::String::New(env, "emSize"), Napi::Number::New(env, scale * emSize));
-          // bounds
-          obj.Set(Napi::String::New(env, "r"), Napi::Number::New(env, scale * bounds.r));
-          obj.Set(Napi::String::New(env, "l"), Napi::Number::New(env, scale * bounds.l));
-          obj.Set(Napi::String::New(env, "t"), Napi::Number::New(env, scale * bounds.t));
-          obj.Set(Napi::String::New(env, "b"), Napi::Number::New(env, scale * bounds.b));
-          // advance
-          obj.Set(Napi::String::New(env, "advance"), Napi::Number::New(env, advance));
-        }
-      }
-      destroyFont(font);
-    }
-    deinitializeFreetype(ft);
+  // one-off session; use FontSession from JS to keep the font open across many glyphs
+  FontSession session(font_path);
+  GlyphRender glyph;
+  if (!session.buildGlyph(glyph, code, code_is_index, size, range, parseSDFType(type), packed)) return obj;
+
+  return glyphToObject(env, glyph, true);
+}
+
+/**
+ *
+ *
+ *
+ * BUILD FONT GLYPHS
+ *
+ *
+ *
+**/
+
+Napi::Object buildFontGlyphs(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // create object
+  Napi::Object obj = Napi::Object::New(env);
+  // check input
+  if (info.Length() < 6 || info.Length() > 10) {
+    Napi::Error::New(env, "Expected six to ten arguments (fontPath, codes, flags, size, range, type, threads?, headerSize?, packed?, cacheDir?)")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+  if (!info[0].IsString()) {
+    Napi::Error::New(env, "Expected the first argument to be a string (fontPath)")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+  if (!checkGlyphBatchArgs(info, 1) || !checkCacheDirArg(info, 9)) return obj;
+
+  std::string font_path = info[0].As<Napi::String>().Utf8Value();
+  FontSession session(font_path);
+  if (!session.isOpen()) {
+    Napi::Error::New(env, "Failed to load font " + font_path)
+        .ThrowAsJavaScriptException();
+    return obj;
   }
 
-  // obj.Set(Napi::String::New(env, "res"), Napi::Number::New(env, 1));
+  return buildGlyphBatch(info, 1, session);
+}
 
-  return obj;
+/**
+ *
+ *
+ *
+ * FONT SESSION
+ *
+ *
+ *
+**/
+
+class FontSessionWrap : public Napi::ObjectWrap<FontSessionWrap> {
+
+public:
+  static Napi::Function Init(Napi::Env env);
+  FontSessionWrap(const Napi::CallbackInfo& info);
+
+private:
+  Napi::Value BuildGlyph(const Napi::CallbackInfo& info);
+  Napi::Value BuildGlyphs(const Napi::CallbackInfo& info);
+  Napi::Value Close(const Napi::CallbackInfo& info);
+
+  std::unique_ptr<FontSession> session;
+
+};
+
+Napi::Function FontSessionWrap::Init(Napi::Env env) {
+  return DefineClass(env, "FontSession", {
+    InstanceMethod("buildGlyph", &FontSessionWrap::BuildGlyph),
+    InstanceMethod("buildGlyphs", &FontSessionWrap::BuildGlyphs),
+    InstanceMethod("close", &FontSessionWrap::Close)
+  });
+}
+
+FontSessionWrap::FontSessionWrap(const Napi::CallbackInfo& info) : Napi::ObjectWrap<FontSessionWrap>(info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 1 || !info[0].IsString()) {
+    Napi::Error::New(env, "Expected the first argument to be a string (fontPath)")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+  std::string font_path = info[0].As<Napi::String>().Utf8Value();
+  session.reset(new FontSession(font_path));
+  if (!session->isOpen()) {
+    Napi::Error::New(env, "Failed to load font " + font_path)
+        .ThrowAsJavaScriptException();
+  }
+}
+
+Napi::Value FontSessionWrap::BuildGlyph(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // check input
+  if (info.Length() != 5 && info.Length() != 6) {
+    Napi::Error::New(env, "Expected five or six arguments (code, size, range, type, codeIsIndex, packed?)")
+        .ThrowAsJavaScriptException();
+    return Napi::Object::New(env);
+  }
+  if (!info[0].IsNumber()) {
+    Napi::Error::New(env, "Expected the first argument to be a number (utf code)")
+        .ThrowAsJavaScriptException();
+    return Napi::Object::New(env);
+  }
+  if (!info[1].IsNumber()) {
+    Napi::Error::New(env, "Expected the second argument to be a number (size)")
+        .ThrowAsJavaScriptException();
+    return Napi::Object::New(env);
+  }
+  if (!info[2].IsNumber()) {
+    Napi::Error::New(env, "Expected the third argument to be a number (range)")
+        .ThrowAsJavaScriptException();
+    return Napi::Object::New(env);
+  }
+  if (!info[3].IsString()) {
+    Napi::Error::New(env, "Expected the fourth argument to be a string (type)")
+        .ThrowAsJavaScriptException();
+    return Napi::Object::New(env);
+  }
+  if (!info[4].IsBoolean()) {
+    Napi::Error::New(env, "Expected the fifth argument to be a boolean (codeIsIndex)")
+        .ThrowAsJavaScriptException();
+    return Napi::Object::New(env);
+  }
+  if (info.Length() > 5 && !info[5].IsUndefined() && !info[5].IsBoolean()) {
+    Napi::Error::New(env, "Expected the sixth argument to be a boolean (packed)")
+        .ThrowAsJavaScriptException();
+    return Napi::Object::New(env);
+  }
+  if (!session || !session->isOpen()) {
+    Napi::Error::New(env, "FontSession is closed")
+        .ThrowAsJavaScriptException();
+    return Napi::Object::New(env);
+  }
+
+  int code = info[0].As<Napi::Number>().Int32Value();
+  float size = info[1].As<Napi::Number>().FloatValue();
+  float range = info[2].As<Napi::Number>().FloatValue();
+  std::string type = info[3].As<Napi::String>().Utf8Value();
+  bool code_is_index = info[4].As<Napi::Boolean>().Value();
+  bool packed = info.Length() > 5 && info[5].IsBoolean() && info[5].As<Napi::Boolean>().Value();
+
+  GlyphRender glyph;
+  if (!session->buildGlyph(glyph, code, code_is_index, size, range, parseSDFType(type), packed)) return Napi::Object::New(env);
+
+  return glyphToObject(env, glyph, true);
+}
+
+Napi::Value FontSessionWrap::BuildGlyphs(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // check input
+  if (info.Length() < 5 || info.Length() > 9) {
+    Napi::Error::New(env, "Expected five to nine arguments (codes, flags, size, range, type, threads?, headerSize?, packed?, cacheDir?)")
+        .ThrowAsJavaScriptException();
+    return Napi::Object::New(env);
+  }
+  if (!checkGlyphBatchArgs(info, 0) || !checkCacheDirArg(info, 8)) return Napi::Object::New(env);
+  if (!session || !session->isOpen()) {
+    Napi::Error::New(env, "FontSession is closed")
+        .ThrowAsJavaScriptException();
+    return Napi::Object::New(env);
+  }
+
+  return buildGlyphBatch(info, 0, *session);
+}
+
+Napi::Value FontSessionWrap::Close(const Napi::CallbackInfo& info) {
+  if (session) session->close();
+  return info.Env().Undefined();
 }
 
 /**
@@ -223,8 +482,8 @@ Napi::Object buildSVGGlyph(const Napi::CallbackInfo& info) {
   // create object
   Napi::Object obj = Napi::Object::New(env);
   // check input
-  if (info.Length() != 5) {
-    Napi::Error::New(env, "Expected five arguments (iconPath, size, range, path_index, type)")
+  if (info.Length() != 5 && info.Length() != 6) {
+    Napi::Error::New(env, "Expected five or six arguments (iconPath, size, range, path_index, type, packed?)")
         .ThrowAsJavaScriptException();
     return obj;
   }
@@ -253,6 +512,11 @@ Napi::Object buildSVGGlyph(const Napi::CallbackInfo& info) {
         .ThrowAsJavaScriptException();
     return obj;
   }
+  if (info.Length() > 5 && !info[5].IsUndefined() && !info[5].IsBoolean()) {
+    Napi::Error::New(env, "Expected the sixth argument to be a boolean (packed)")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
 
   // https://github.com/Chlumsky/msdfgen/issues/119
   std::string svg_path = info[0].As<Napi::String>().Utf8Value();
@@ -260,132 +524,589 @@ Napi::Object buildSVGGlyph(const Napi::CallbackInfo& info) {
   float range = info[2].As<Napi::Number>().FloatValue();
   int path_index = info[3].As<Napi::Number>().Int32Value();
   std::string type = info[4].As<Napi::String>().Utf8Value();
-
-  char svg_path_arr[svg_path.size() + 1];
-  strcpy(svg_path_arr, svg_path.c_str());
+  bool packed = info.Length() > 5 && info[5].IsBoolean() && info[5].As<Napi::Boolean>().Value();
 
   // https://github.com/Chlumsky/msdfgen/issues/117
 
   Shape shape;
   Vector2 dimensions;
-  if (loadSvgShape(shape, svg_path_arr, path_index, &dimensions)) {
-    shape.normalize();
-    if (resolveShapeGeometry(shape)) {
-      edgeColoringByDistance(shape, 3., 0.);
-      // grab data
-      int shape_size = shape.contours.size();
-      float emSize = dimensions.y;
-      // build scale
-      float scale = size / emSize;
-      // update range by scale
-      range = 0.5 * range / scale;
-      // prep data
-      // Shape::Bounds actual_bounds = shape.getBounds(0);
-      Shape::Bounds bounds = shape.getBounds(range);
-      // Calculate width & height
-      int glyph_width = ceil(scale * (bounds.r - bounds.l));
-      int glyph_height = ceil(scale * (bounds.t - bounds.b));
-      // store the msdf in a byte array
-      byte *data;
-
-      int length, width, height;
-
-      // depending upon type, build
-      if (strcmp(type.c_str(), "mtsdf") == 0) {
-        Bitmap<float, 4> mtsdf(glyph_width, glyph_height);
-        generateMTSDF(mtsdf, shape, range * 2., scale, Vector2(-bounds.l, -bounds.b));
-        width = mtsdf.width();
-        height = mtsdf.height();
-        length = 4 * width * height;
-        data = new byte[length];
-        for (int y = 0; y < height; y++) {
-          for (int x = 0; x < width; x++) {
-            size_t idx = (width * y + x) << 2;
-            data[idx] = pixelFloatToByte(mtsdf(x, y)[0]);
-            data[idx + 1] = pixelFloatToByte(mtsdf(x, y)[1]);
-            data[idx + 2] = pixelFloatToByte(mtsdf(x, y)[2]);
-            data[idx + 3] = pixelFloatToByte(mtsdf(x, y)[3]);
-          }
-        }
-      } else if (strcmp(type.c_str(), "msdf") == 0) {
-        Bitmap<float, 3> msdf(glyph_width, glyph_height);
-        generateMSDF(msdf, shape, range * 2., scale, Vector2(-bounds.l, -bounds.b));
-        width = msdf.width();
-        height = msdf.height();
-        length = 4 * width * height;
-        data = new byte[length];
-        for (int y = 0; y < height; y++) {
-          for (int x = 0; x < width; x++) {
-            size_t idx = (width * y + x) << 2;
-            data[idx] = pixelFloatToByte(msdf(x, y)[0]);
-            data[idx + 1] = pixelFloatToByte(msdf(x, y)[1]);
-            data[idx + 2] = pixelFloatToByte(msdf(x, y)[2]);
-            data[idx + 3] = 255;
-          }
-        }
-      } else if (strcmp(type.c_str(), "psdf") == 0) {
-        Bitmap<float, 1> psdf(glyph_width, glyph_height);
-        generatePseudoSDF(psdf, shape, range * 2., scale, Vector2(-bounds.l, -bounds.b));
-        width = psdf.width();
-        height = psdf.height();
-        length = 4 * width * height;
-        data = new byte[length];
-        for (int y = 0; y < height; y++) {
-          for (int x = 0; x < width; x++) {
-            size_t idx = (width * y + x) << 2;
-            auto pixel = pixelFloatToByte(psdf(x, y)[0]);
-            data[idx] = pixel;
-            data[idx + 1] = pixel;
-            data[idx + 2] = pixel;
-            data[idx + 3] = 255;
-          }
-        }
-      } else {
-        // sdf
-        Bitmap<float, 1> msdf(glyph_width, glyph_height);
-        generateSDF(msdf, shape, range * 2., scale, Vector2(-bounds.l, -bounds.b));
-        width = msdf.width();
-        height = msdf.height();
-        length = 4 * width * height;
-        data = new byte[length];
-        for (int y = 0; y < height; y++) {
-          for (int x = 0; x < width; x++) {
-            size_t idx = (width * y + x) << 2;
-            auto pixel = pixelFloatToByte(msdf(x, y)[0]);
-            data[idx] = pixel;
-            data[idx + 1] = pixel;
-            data[idx + 2] = pixel;
-            data[idx + 3] = 255;
-          }
-        }
-      }
+  GlyphRender glyph;
+  if (packed) glyph.channels = sdfTypeChannels(parseSDFType(type));
+  if (!loadSvgShape(shape, svg_path.c_str(), path_index, &dimensions)) return obj;
+  if (!renderShape(glyph, shape, dimensions.y, size, range, parseSDFType(type))) return obj;
 
-      obj.Set(Napi::String::New(env, "data"), Napi::ArrayBuffer::New(env, data, length, [](Env /*env*/, void* finalizeData) {
-        free(finalizeData);
-      }));
-      obj.Set(Napi::String::New(env, "width"), Napi::Number::New(env, width));
-      obj.Set(Napi::String::New(env, "height"), Napi::Number::New(env, height));
-      obj.Set(Napi::String::New(env, "shapeSize"), Napi::Number::New(env, shape_size));
-      obj.Set(Napi::String::New(env, "emSize"), Napi::Number::New(env, scale * emSize));
-      // bounds
-      obj.Set(Napi::String::New(env, "r"), Napi::Number::New(env, scale * bounds.r));
-      obj.Set(Napi::String::New(env, "l"), Napi::Number::New(env, scale * bounds.l));
-      obj.Set(Napi::String::New(env, "t"), Napi::Number::New(env, scale * bounds.t));
-      obj.Set(Napi::String::New(env, "b"), Napi::Number::New(env, scale * bounds.b));
-      // advance
-      double advance = 0;
-      obj.Set(Napi::String::New(env, "advance"), Napi::Number::New(env, advance));
+  return glyphToObject(env, glyph, false);
+}
+
+/**
+ *
+ *
+ *
+ * BUILD SVG GLYPHS
+ *
+ *
+ *
+**/
+
+Napi::Object buildSVGGlyphs(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // create object
+  Napi::Object obj = Napi::Object::New(env);
+  // check input
+  if (info.Length() < 5 || info.Length() > 9) {
+    Napi::Error::New(env, "Expected five to nine arguments (iconPath, pathIndices, size, range, type, threads?, headerSize?, packed?, cacheDir?)")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+  if (!info[0].IsString()) {
+    Napi::Error::New(env, "Expected the first argument to be a string (iconPath)")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+  if (!checkSVGBatchArgs(info, 1) || !checkCacheDirArg(info, 8)) return obj;
+
+  std::string svg_path = info[0].As<Napi::String>().Utf8Value();
+  Napi::Uint32Array path_indices = info[1].As<Napi::Uint32Array>();
+  BatchOptions options = readBatchOptions(info, 2);
+  GlyphCache cache(readCacheDir(info, 8));
+  // parse the file once for all of its paths
+  SvgDocument document(svg_path);
+  if (!document.isOpen()) {
+    Napi::Error::New(env, "Failed to load svg " + svg_path)
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+
+  GlyphBatch batch;
+  if (!document.buildGlyphs(batch, path_indices.Data(), path_indices.ElementLength(), options.size, options.range, options.type, options.threads, options.headerSize, options.packed, nullptr, &cache)) {
+    Napi::Error::New(env, GLYPH_BATCH_TOO_LARGE)
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+
+  return glyphsToObject(env, batch, 0);
+}
+
+/**
+ *
+ *
+ *
+ * ASYNC BUILDS
+ *
+ *
+ *
+**/
+
+// Renders a font glyph batch on a background thread and resolves a promise with the batch object
+class FontGlyphsWorker : public Napi::AsyncProgressWorker<uint32_t> {
+
+public:
+  FontGlyphsWorker(
+    Napi::Env env,
+    const std::string &fontPath,
+    Napi::Uint32Array codes,
+    Napi::Uint8Array flags,
+    float size,
+    float range,
+    SDFType type,
+    unsigned threads,
+    size_t headerSize,
+    bool packed,
+    const std::string &cacheDir
+  ) : Napi::AsyncProgressWorker<uint32_t>(env, "buildFontGlyphsAsync"),
+      deferred(Napi::Promise::Deferred::New(env)),
+      fontPath(fontPath),
+      // copied so the caller is free to reuse its arrays while we render
+      codes(codes.Data(), codes.Data() + codes.ElementLength()),
+      flags(flags.Data(), flags.Data() + flags.ElementLength()),
+      size(size), range(range), type(type), threads(threads), headerSize(headerSize), packed(packed), cache(cacheDir), lineHeight(0) {}
+
+  Napi::Promise GetPromise() { return deferred.Promise(); }
+  void SetProgressCallback(Napi::Function callback) { onProgress = Napi::Persistent(callback); }
+
+protected:
+  void Execute(const ExecutionProgress &progress) override {
+    FontSession session(fontPath);
+    if (!session.isOpen()) {
+      SetError("Failed to load font " + fontPath);
+      return;
     }
+    std::function<void(size_t)> onGlyph;
+    if (!onProgress.IsEmpty()) {
+      onGlyph = [&progress](size_t done) {
+        uint32_t count = (uint32_t) done;
+        progress.Send(&count, 1);
+      };
+    }
+    if (!session.buildGlyphs(batch, codes.data(), flags.data(), codes.size(), size, range, type, threads, headerSize, packed, onGlyph, &cache)) {
+      SetError(GLYPH_BATCH_TOO_LARGE);
+      return;
+    }
+    lineHeight = session.lineHeight(size);
+  }
+
+  void OnProgress(const uint32_t *done, size_t count) override {
+    if (count == 0 || onProgress.IsEmpty()) return;
+    Napi::Env env = Env();
+    onProgress.Call({Napi::Number::New(env, *done), Napi::Number::New(env, codes.size())});
+  }
+
+  void OnOK() override {
+    deferred.Resolve(glyphsToObject(Env(), batch, lineHeight));
+  }
+
+  void OnError(const Napi::Error &error) override {
+    deferred.Reject(error.Value());
+  }
+
+private:
+  Napi::Promise::Deferred deferred;
+  Napi::FunctionReference onProgress;
+  std::string fontPath;
+  std::vector<uint32_t> codes;
+  std::vector<uint8_t> flags;
+  float size;
+  float range;
+  SDFType type;
+  unsigned threads;
+  size_t headerSize;
+  bool packed;
+  GlyphCache cache;
+  GlyphBatch batch;
+  double lineHeight;
+
+};
+
+Napi::Value buildFontGlyphsAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // check input
+  if (info.Length() < 6 || info.Length() > 11) {
+    Napi::Error::New(env, "Expected six to eleven arguments (fontPath, codes, flags, size, range, type, threads?, headerSize?, packed?, onProgress?, cacheDir?)")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (!info[0].IsString()) {
+    Napi::Error::New(env, "Expected the first argument to be a string (fontPath)")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (!checkGlyphBatchArgs(info, 1)) return env.Undefined();
+  if (info.Length() > 9 && !info[9].IsUndefined() && !info[9].IsFunction()) {
+    Napi::Error::New(env, "Expected the tenth argument to be a function (onProgress)")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (!checkCacheDirArg(info, 10)) return env.Undefined();
+
+  FontGlyphsWorker *worker = new FontGlyphsWorker(
+    env,
+    info[0].As<Napi::String>().Utf8Value(),
+    info[1].As<Napi::Uint32Array>(),
+    info[2].As<Napi::Uint8Array>(),
+    info[3].As<Napi::Number>().FloatValue(),
+    info[4].As<Napi::Number>().FloatValue(),
+    parseSDFType(info[5].As<Napi::String>().Utf8Value()),
+    info.Length() > 6 && info[6].IsNumber() ? info[6].As<Napi::Number>().Uint32Value() : 0,
+    info.Length() > 7 && info[7].IsNumber() ? info[7].As<Napi::Number>().Uint32Value() : 0,
+    info.Length() > 8 && info[8].IsBoolean() && info[8].As<Napi::Boolean>().Value(),
+    readCacheDir(info, 10)
+  );
+  if (info.Length() > 9 && info[9].IsFunction()) worker->SetProgressCallback(info[9].As<Napi::Function>());
+  Napi::Promise promise = worker->GetPromise();
+  worker->Queue();
+
+  return promise;
+}
+
+// Renders an SVG glyph on a background thread and resolves a promise with the glyph object
+class SVGGlyphWorker : public Napi::AsyncWorker {
+
+public:
+  SVGGlyphWorker(Napi::Env env, const std::string &svgPath, float size, float range, int pathIndex, SDFType type, bool packed)
+    : Napi::AsyncWorker(env, "buildSVGGlyphAsync"),
+      deferred(Napi::Promise::Deferred::New(env)),
+      svgPath(svgPath), size(size), range(range), pathIndex(pathIndex), type(type), rendered(false) {
+    if (packed) glyph.channels = sdfTypeChannels(type);
+  }
+
+  Napi::Promise GetPromise() { return deferred.Promise(); }
+
+protected:
+  void Execute() override {
+    Shape shape;
+    Vector2 dimensions;
+    if (!loadSvgShape(shape, svgPath.c_str(), pathIndex, &dimensions)) return;
+    rendered = renderShape(glyph, shape, dimensions.y, size, range, type);
   }
 
+  void OnOK() override {
+    if (!rendered) deferred.Resolve(Napi::Object::New(Env()));
+    else deferred.Resolve(glyphToObject(Env(), glyph, false));
+  }
+
+  void OnError(const Napi::Error &error) override {
+    deferred.Reject(error.Value());
+  }
+
+private:
+  Napi::Promise::Deferred deferred;
+  std::string svgPath;
+  float size;
+  float range;
+  int pathIndex;
+  SDFType type;
+  GlyphRender glyph;
+  bool rendered;
+
+};
+
+Napi::Value buildSVGGlyphAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // check input
+  if (info.Length() != 5 && info.Length() != 6) {
+    Napi::Error::New(env, "Expected five or six arguments (iconPath, size, range, path_index, type, packed?)")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (!info[0].IsString()) {
+    Napi::Error::New(env, "Expected the first argument to be a string (iconPath)")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (!info[1].IsNumber()) {
+    Napi::Error::New(env, "Expected the second argument to be a number (size)")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (!info[2].IsNumber()) {
+    Napi::Error::New(env, "Expected the third argument to be a number (range)")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (!info[3].IsNumber()) {
+    Napi::Error::New(env, "Expected the fourth argument to be a number (path_index)")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (!info[4].IsString()) {
+    Napi::Error::New(env, "Expected the fifth argument to be a string (type)")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (info.Length() > 5 && !info[5].IsUndefined() && !info[5].IsBoolean()) {
+    Napi::Error::New(env, "Expected the sixth argument to be a boolean (packed)")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  SVGGlyphWorker *worker = new SVGGlyphWorker(
+    env,
+    info[0].As<Napi::String>().Utf8Value(),
+    info[1].As<Napi::Number>().FloatValue(),
+    info[2].As<Napi::Number>().FloatValue(),
+    info[3].As<Napi::Number>().Int32Value(),
+    parseSDFType(info[4].As<Napi::String>().Utf8Value()),
+    info.Length() > 5 && info[5].IsBoolean() && info[5].As<Napi::Boolean>().Value()
+  );
+  Napi::Promise promise = worker->GetPromise();
+  worker->Queue();
+
+  return promise;
+}
+
+// Renders a batch of paths of one SVG file on a background thread and resolves a promise with the batch object
+class SVGGlyphsWorker : public Napi::AsyncWorker {
+
+public:
+  SVGGlyphsWorker(Napi::Env env, const std::string &svgPath, Napi::Uint32Array pathIndices, const BatchOptions &options, const std::string &cacheDir)
+    : Napi::AsyncWorker(env, "buildSVGGlyphsAsync"),
+      deferred(Napi::Promise::Deferred::New(env)),
+      svgPath(svgPath),
+      // copied so the caller is free to reuse its array while we render
+      pathIndices(pathIndices.Data(), pathIndices.Data() + pathIndices.ElementLength()),
+      options(options), cache(cacheDir) {}
+
+  Napi::Promise GetPromise() { return deferred.Promise(); }
+
+protected:
+  void Execute() override {
+    SvgDocument document(svgPath);
+    if (!document.isOpen()) {
+      SetError("Failed to load svg " + svgPath);
+      return;
+    }
+    if (!document.buildGlyphs(batch, pathIndices.data(), pathIndices.size(), options.size, options.range, options.type, options.threads, options.headerSize, options.packed, nullptr, &cache))
+      SetError(GLYPH_BATCH_TOO_LARGE);
+  }
+
+  void OnOK() override {
+    deferred.Resolve(glyphsToObject(Env(), batch, 0));
+  }
+
+  void OnError(const Napi::Error &error) override {
+    deferred.Reject(error.Value());
+  }
+
+private:
+  Napi::Promise::Deferred deferred;
+  std::string svgPath;
+  std::vector<uint32_t> pathIndices;
+  BatchOptions options;
+  GlyphCache cache;
+  GlyphBatch batch;
+
+};
+
+Napi::Value buildSVGGlyphsAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // check input
+  if (info.Length() < 5 || info.Length() > 9) {
+    Napi::Error::New(env, "Expected five to nine arguments (iconPath, pathIndices, size, range, type, threads?, headerSize?, packed?, cacheDir?)")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (!info[0].IsString()) {
+    Napi::Error::New(env, "Expected the first argument to be a string (iconPath)")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (!checkSVGBatchArgs(info, 1) || !checkCacheDirArg(info, 8)) return env.Undefined();
+
+  SVGGlyphsWorker *worker = new SVGGlyphsWorker(
+    env,
+    info[0].As<Napi::String>().Utf8Value(),
+    info[1].As<Napi::Uint32Array>(),
+    readBatchOptions(info, 2),
+    readCacheDir(info, 8)
+  );
+  Napi::Promise promise = worker->GetPromise();
+  worker->Queue();
+
+  return promise;
+}
+
+/**
+ *
+ *
+ *
+ * ATLAS
+ *
+ *
+ *
+**/
+
+Napi::Object packAtlas(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // create object
+  Napi::Object obj = Napi::Object::New(env);
+  // check input
+  if (info.Length() < 4 || info.Length() > 5) {
+    Napi::Error::New(env, "Expected four or five arguments (widths, heights, pageWidth, pageHeight, padding?)")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+  if (!info[0].IsTypedArray() || info[0].As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array) {
+    Napi::Error::New(env, "Expected widths to be a Uint32Array")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+  if (!info[1].IsTypedArray() || info[1].As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array) {
+    Napi::Error::New(env, "Expected heights to be a Uint32Array")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+  if (!info[2].IsNumber() || !info[3].IsNumber()) {
+    Napi::Error::New(env, "Expected pageWidth and pageHeight to be numbers")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+  if (info.Length() > 4 && !info[4].IsUndefined() && !info[4].IsNumber()) {
+    Napi::Error::New(env, "Expected padding to be a number")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+
+  Napi::Uint32Array widths = info[0].As<Napi::Uint32Array>();
+  Napi::Uint32Array heights = info[1].As<Napi::Uint32Array>();
+  if (widths.ElementLength() != heights.ElementLength()) {
+    Napi::Error::New(env, "Expected widths and heights to have the same length")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+  int padding = info.Length() > 4 && info[4].IsNumber() ? info[4].As<Napi::Number>().Int32Value() : 0;
+  size_t count = widths.ElementLength();
+  Napi::Int32Array placements = Napi::Int32Array::New(env, count * 3);
+  AtlasPacker packer(info[2].As<Napi::Number>().Int32Value(), info[3].As<Napi::Number>().Int32Value(), padding);
+  int pages = packer.pack(widths.Data(), heights.Data(), count, placements.Data());
+
+  obj.Set(Napi::String::New(env, "placements"), placements);
+  obj.Set(Napi::String::New(env, "pages"), Napi::Number::New(env, pages));
+  return obj;
+}
+
+/**
+ *
+ *
+ *
+ * MAPPED FILES
+ *
+ *
+ *
+**/
+
+Napi::Value mapFile(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // check input
+  if (info.Length() != 1 || !info[0].IsString()) {
+    Napi::Error::New(env, "Expected one argument (filePath)")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  std::string file_path = info[0].As<Napi::String>().Utf8Value();
+  MappedFile *file = new MappedFile(file_path);
+  if (!file->isOpen()) {
+    delete file;
+    Napi::Error::New(env, "Failed to map " + file_path)
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  // the mapping lives as long as the buffer; it is read only, so writing to it crashes
+  return Napi::ArrayBuffer::New(env, (void *) file->data(), file->size(), [](Env /*env*/, void* /*data*/, MappedFile *hint) {
+    delete hint;
+  }, file);
+}
+
+/**
+ *
+ *
+ *
+ * RENDER COMPARISONS
+ *
+ *
+ *
+**/
+
+typedef std::function<void(byte *pixels, const GlyphRender &glyph, const Shape &shape, SDFType type)> RenderFn;
+
+// render every glyph of (fontPath, glyphIndices, size, range, type) both ways, timing each, and compare the bytes
+Napi::Object compareRenders(const Napi::CallbackInfo& info, const RenderFn &render_reference, const RenderFn &render_test) {
+  Napi::Env env = info.Env();
+  // create object
+  Napi::Object obj = Napi::Object::New(env);
+  // check input
+  if (info.Length() != 5) {
+    Napi::Error::New(env, "Expected five arguments (fontPath, glyphIndices, size, range, type)")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+  if (!info[0].IsString()) {
+    Napi::Error::New(env, "Expected the first argument to be a string (fontPath)")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+  if (!info[1].IsTypedArray() || info[1].As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array) {
+    Napi::Error::New(env, "Expected glyphIndices to be a Uint32Array")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+  if (!info[2].IsNumber() || !info[3].IsNumber()) {
+    Napi::Error::New(env, "Expected size and range to be numbers")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+  if (!info[4].IsString()) {
+    Napi::Error::New(env, "Expected the fifth argument to be a string (type)")
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+
+  std::string font_path = info[0].As<Napi::String>().Utf8Value();
+  Napi::Uint32Array indices = info[1].As<Napi::Uint32Array>();
+  float size = info[2].As<Napi::Number>().FloatValue();
+  float range = info[3].As<Napi::Number>().FloatValue();
+  SDFType type = parseSDFType(info[4].As<Napi::String>().Utf8Value());
+
+  FontSession session(font_path);
+  if (!session.isOpen()) {
+    Napi::Error::New(env, "Failed to load font " + font_path)
+        .ThrowAsJavaScriptException();
+    return obj;
+  }
+
+  // empty glyphs are skipped
+  size_t glyphs = 0, bytes = 0, differing_bytes = 0;
+  int max_difference = 0;
+  uint32_t max_difference_index = 0;
+  std::chrono::steady_clock::duration reference_time(0), test_time(0);
+  std::vector<byte> reference, test;
+  for (size_t i = 0; i < indices.ElementLength(); i++) {
+    GlyphRender glyph;
+    Shape shape;
+    if (!session.prepareGlyph(glyph, shape, indices[i], true, size, range)) continue;
+    size_t length = glyphByteLength(glyph);
+    reference.assign(length, 0);
+    test.assign(length, 0);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    render_reference(reference.data(), glyph, shape, type);
+    std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+    render_test(test.data(), glyph, shape, type);
+    test_time += std::chrono::steady_clock::now() - middle;
+    reference_time += middle - start;
+    glyphs++;
+    bytes += length;
+    for (size_t j = 0; j < length; j++) {
+      int difference = std::abs((int) reference[j] - (int) test[j]);
+      if (difference == 0) continue;
+      differing_bytes++;
+      if (difference > max_difference) {
+        max_difference = difference;
+        max_difference_index = indices[i];
+      }
+    }
+  }
+
+  obj.Set(Napi::String::New(env, "glyphs"), Napi::Number::New(env, (double) glyphs));
+  obj.Set(Napi::String::New(env, "bytes"), Napi::Number::New(env, (double) bytes));
+  obj.Set(Napi::String::New(env, "differingBytes"), Napi::Number::New(env, (double) differing_bytes));
+  obj.Set(Napi::String::New(env, "maxDifference"), Napi::Number::New(env, max_difference));
+  obj.Set(Napi::String::New(env, "maxDifferenceIndex"), Napi::Number::New(env, max_difference_index));
+  obj.Set(Napi::String::New(env, "referenceMs"), Napi::Number::New(env, std::chrono::duration<double, std::milli>(reference_time).count()));
+  obj.Set(Napi::String::New(env, "testMs"), Napi::Number::New(env, std::chrono::duration<double, std::milli>(test_time).count()));
   return obj;
 }
 
+// solving a cubic equation for the closest point on quadratic curves (reference) against refining the previous one (test)
+Napi::Object compareQuadraticSearch(const Napi::CallbackInfo& info) {
+  return compareRenders(info, [](byte *pixels, const GlyphRender &glyph, const Shape &shape, SDFType type) {
+    generateShape(pixels, glyph, shape, type, false);
+  }, [](byte *pixels, const GlyphRender &glyph, const Shape &shape, SDFType type) {
+    generateShape(pixels, glyph, shape, type, true);
+  });
+}
+
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
   exports.Set(Napi::String::New(env, "buildFontGlyph"),
               Napi::Function::New(env, buildFontGlyph));
+  exports.Set(Napi::String::New(env, "buildFontGlyphs"),
+              Napi::Function::New(env, buildFontGlyphs));
   exports.Set(Napi::String::New(env, "buildSVGGlyph"),
               Napi::Function::New(env, buildSVGGlyph));
+  exports.Set(Napi::String::New(env, "buildFontGlyphsAsync"),
+              Napi::Function::New(env, buildFontGlyphsAsync));
+  exports.Set(Napi::String::New(env, "buildSVGGlyphAsync"),
+              Napi::Function::New(env, buildSVGGlyphAsync));
+  exports.Set(Napi::String::New(env, "buildSVGGlyphs"),
+              Napi::Function::New(env, buildSVGGlyphs));
+  exports.Set(Napi::String::New(env, "buildSVGGlyphsAsync"),
+              Napi::Function::New(env, buildSVGGlyphsAsync));
+  exports.Set(Napi::String::New(env, "packAtlas"),
+              Napi::Function::New(env, packAtlas));
+  exports.Set(Napi::String::New(env, "mapFile"),
+              Napi::Function::New(env, mapFile));
+  exports.Set(Napi::String::New(env, "compareQuadraticSearch"),
+              Napi::Function::New(env, compareQuadraticSearch));
+  exports.Set(Napi::String::New(env, "FontSession"),
+              FontSessionWrap::Init(env));
   return exports;
 }
 
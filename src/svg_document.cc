@@ -0,0 +1,58 @@
+#include "svg_document.h"
+
+#include "work_stealing.h"
+
+SvgDocument::SvgDocument(const std::string &svgPath) : loaded(false) {
+  loaded = loadSvgShapes(svgPaths, svgPath.c_str(), &svgDimensions);
+}
+
+bool SvgDocument::isOpen() const {
+  return loaded;
+}
+
+const std::vector<SvgPath> &SvgDocument::paths() const {
+  return svgPaths;
+}
+
+const Vector2 &SvgDocument::dimensions() const {
+  return svgDimensions;
+}
+
+bool SvgDocument::buildGlyph(GlyphRender &result, size_t index, float size, float range, SDFType type) const {
+  Shape shape;
+  if (!prepareGlyph(result, shape, index, size, range)) return false;
+  result.data.resize(glyphByteLength(result));
+  generateShape(result.data.data(), result, shape, type);
+
+  return true;
+}
+
+bool SvgDocument::prepareGlyph(GlyphRender &result, Shape &shape, size_t index, float size, float range) const {
+  if (index >= svgPaths.size()) return false;
+  // prepareShape normalizes in place, the parsed path stays untouched for later renders
+  shape = svgPaths[index].shape;
+  return prepareShape(result, shape, svgDimensions.y, size, range);
+}
+
+bool SvgDocument::buildGlyphs(GlyphBatch &batch, const uint32_t *indices, size_t count, float size, float range, SDFType type, unsigned threads, size_t headerSize, bool packed, const std::function<void(size_t done)> &onGlyph, const GlyphCache *cache) const {
+  std::vector<GlyphRender> &glyphs = batch.glyphs;
+  glyphs.clear();
+  glyphs.resize(count);
+  batch.offsets.assign(count, -1);
+  batch.headerSize = headerSize;
+  std::vector<Shape> shapes(count);
+  int channels = packed ? sdfTypeChannels(type) : 4;
+  batch.channels = channels;
+  threads = resolveThreadCount(threads, count);
+
+  // 1) lay out every path so the arena size is known up front
+  std::vector<char> prepared(count, 0);
+  parallelFor(count, threads, [&](unsigned /*worker*/, size_t i) {
+    if (prepareGlyph(glyphs[i], shapes[i], indices[i], size, range)) prepared[i] = 1;
+    else glyphs[i] = GlyphRender();
+    glyphs[i].channels = channels;
+  });
+
+  // 2) allocate the arena and generate every glyph straight into its slot
+  return generateGlyphBatch(batch, shapes, prepared, type, threads, onGlyph, cache);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "glyph_render.h"
+
+/**
+ * An SVG file parsed once: the geometry and style of every <path> element and the document's
+ * dimensions, so that any number of its paths can be rendered without re-reading the file.
+ * Paths are numbered from 0 in document order (loadSvgShape's pathIndex minus one).
+ * Read-only once loaded, so it may be shared between threads.
+ */
+class SvgDocument {
+
+public:
+  explicit SvgDocument(const std::string &svgPath);
+
+  /// True if the file was read and has an <svg> root
+  bool isOpen() const;
+  /// Every <path> element in document order
+  const std::vector<SvgPath> &paths() const;
+  /// Width and height of the viewBox, the em size paths are rendered against
+  const Vector2 &dimensions() const;
+  /// Render a path by index
+  bool buildGlyph(GlyphRender &result, size_t index, float size, float range, SDFType type) const;
+  /// Copy a path's shape and lay it out (see prepareShape) without rendering its pixels
+  bool prepareGlyph(GlyphRender &result, Shape &shape, size_t index, float size, float range) const;
+  /**
+   * Render every path index in order into one arena, the same way FontSession::buildGlyphs does
+   * for font glyphs, cache included. Indices out of range fail like paths without geometry: left empty.
+   * Returns false if the batch is too large for one arena (see generateGlyphBatch).
+   */
+  bool buildGlyphs(GlyphBatch &batch, const uint32_t *indices, size_t count, float size, float range, SDFType type, unsigned threads = 1, size_t headerSize = 0, bool packed = false, const std::function<void(size_t done)> &onGlyph = nullptr, const GlyphCache *cache = nullptr) const;
+
+private:
+  bool loaded;
+  std::vector<SvgPath> svgPaths;
+  Vector2 svgDimensions;
+
+};
@@ -0,0 +1,76 @@
+#include "work_stealing.h"
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+void WorkStealingQueue::push(size_t index) {
+  std::lock_guard<std::mutex> lock(mutex);
+  items.push_back(index);
+}
+
+bool WorkStealingQueue::pop(size_t &index) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (items.empty()) return false;
+  index = items.front();
+  items.pop_front();
+  return true;
+}
+
+bool WorkStealingQueue::steal(size_t &index) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (items.empty()) return false;
+  index = items.back();
+  items.pop_back();
+  return true;
+}
+
+unsigned resolveThreadCount(unsigned threads, size_t count) {
+  if (threads == 0) threads = std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+  if (threads > count) threads = count > 0 ? (unsigned) count : 1;
+  return threads;
+}
+
+void parallelFor(size_t count, unsigned threads, const std::function<void(unsigned worker, size_t index)> &job) {
+  threads = resolveThreadCount(threads, count);
+  if (threads == 1) {
+    for (size_t i = 0; i < count; i++) job(0, i);
+    return;
+  }
+
+  std::vector<std::unique_ptr<WorkStealingQueue>> queues;
+  for (unsigned w = 0; w < threads; w++) queues.emplace_back(new WorkStealingQueue());
+  // deal jobs out round-robin so neighbouring (often similarly expensive) jobs are spread
+  for (size_t i = 0; i < count; i++) queues[i % threads]->push(i);
+
+  std::mutex errorMutex;
+  std::exception_ptr error;
+  std::atomic<bool> failed(false);
+  auto work = [&](unsigned worker) {
+    try {
+      size_t index;
+      while (!failed.load(std::memory_order_relaxed)) {
+        if (!queues[worker]->pop(index)) {
+          // no jobs are ever added, so once every queue is empty the worker is done
+          bool stole = false;
+          for (unsigned k = 1; k < threads && !stole; k++) stole = queues[(worker + k) % threads]->steal(index);
+          if (!stole) break;
+        }
+        job(worker, index);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      if (!error) error = std::current_exception();
+      failed = true;
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (unsigned w = 1; w < threads; w++) pool.emplace_back(work, w);
+  work(0);
+  for (std::thread &thread : pool) thread.join();
+  if (error) std::rethrow_exception(error);
+}
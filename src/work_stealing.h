@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+/**
+ * A worker's queue of job indices. The owner takes from the front while idle workers steal
+ * from the back, so a worker stuck on an expensive job does not hold up the rest of its share.
+ */
+class WorkStealingQueue {
+
+public:
+  void push(size_t index);
+  /// Take the next job of this queue's owner
+  bool pop(size_t &index);
+  /// Take a job on behalf of another worker
+  bool steal(size_t &index);
+
+private:
+  std::deque<size_t> items;
+  std::mutex mutex;
+
+};
+
+/// Number of workers to use for a requested thread count; 0 means one per hardware thread
+unsigned resolveThreadCount(unsigned threads, size_t count);
+
+/**
+ * Run job(worker, index) for every index in [0, count) on `threads` workers. The calling thread
+ * is worker 0. Jobs are dealt out round-robin up front and rebalanced by stealing. The first
+ * exception thrown by a job is rethrown once all workers have stopped.
+ */
+void parallelFor(size_t count, unsigned threads, const std::function<void(unsigned worker, size_t index)> &job);
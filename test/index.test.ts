@@ -2,7 +2,7 @@ import fs from 'fs'
 import sharp from 'sharp'
 import { test, expect } from 'vitest'
 import Database from 'better-sqlite3'
-import { parseGlyph, generateGlyphs, getMetadata } from '../dist'
+import { parseGlyph, parseGlyphBuffer, generateGlyphs, getMetadata, buildMetadata, parseMetadata, getGlyph, getGlyphs, getGlyphRange, parseGlyphRange, migrateDatabase, buildGlyphPack, GlyphPackReader, SCHEMA_VERSION } from '../dist'
 
 const SCHEMA = fs.readFileSync('./lib/schema.sql', 'utf8')
 
@@ -43,6 +43,7 @@ test('processing a font into SQL', async (): Promise<void> => {
     expect(maxHeight).toEqual(49)
     expect(range).toEqual(6)
     expect(defaultAdvance).toEqual(0.2490234375)
+    expect(metadata.channels).toEqual(4)
     // expect(substitutes).toEqual([
     //   { type: 4, substitute: '102.102.105', components: [102, 102, 105] },
     //   { type: 4, substitute: '102.105', components: [102, 105] },
@@ -66,6 +67,30 @@ test('processing a font into SQL', async (): Promise<void> => {
     expect(width).toEqual(6848)
     expect(height).toEqual(7360)
     expect(advanceWidth).toEqual(10904)
+    expect(glyph.channels).toEqual(4)
+  }
+
+  // duplicated outlines (lookalikes such as Latin A and Cyrillic A) are stored once, yet every
+  // aliased code point still reads back as the glyph it shares, under its own unicode
+  {
+    expect(metadata.aliases.size).toBeGreaterThan(0)
+    for (const [unicode, target] of metadata.aliases) {
+      const aliased = getGlyph(db, String(unicode), name)
+      const shared = getGlyph(db, String(target), name)
+      if (aliased === undefined || shared === undefined) throw new Error(`alias ${unicode} is missing`)
+      expect(parseGlyphBuffer(String(unicode), aliased).unicode).toEqual(unicode)
+      expect(aliased.subarray(2)).toEqual(shared.subarray(2))
+      const { code, unicode: parsed } = parseGlyph(db, String(unicode), name)
+      expect(code).toEqual(String(unicode))
+      expect(parsed).toEqual(unicode)
+    }
+    // and batched reads pack the same copies under each aliased code
+    const aliased = [...metadata.aliases.keys()].map(String)
+    const { codes, offsets, data } = getGlyphs(db, aliased, name)
+    expect(codes).toEqual(aliased)
+    for (const [i, unicode] of codes.entries()) {
+      expect(data.subarray(offsets[i], offsets[i + 1])).toEqual(getGlyph(db, unicode, name))
+    }
   }
 
   // try grabbing a replacement glyph
@@ -88,6 +113,16 @@ test('processing a font into SQL', async (): Promise<void> => {
     // await png.toFile('./tmp.png')
   }
 
+  // grab the first range in one query
+  {
+    const { codes, offsets, data } = getGlyphRange(db, 0, 255, name)
+    expect(codes.length).toBeGreaterThan(0)
+    expect(offsets.length).toEqual(codes.length + 1)
+    expect(data.length).toEqual(offsets[codes.length])
+    const i = codes.indexOf(codeA)
+    expect(data.subarray(offsets[i], offsets[i + 1])).toEqual(getGlyph(db, codeA, name))
+  }
+
   // CLEANUP
   db.close()
   if (fs.existsSync(out)) fs.unlinkSync(out)
@@ -95,6 +130,144 @@ test('processing a font into SQL', async (): Promise<void> => {
   if (fs.existsSync(`${out}-wal`)) fs.unlinkSync(`${out}-wal`)
 })
 
+test('migrating a version 1 SQL store', (): void => {
+  const out = './tmp-migrate-v1.sqlite'
+  const db = new Database(out)
+  // the version 1 schema: base64 TEXT in rowid tables, with nullable names
+  db.exec(`
+    CREATE TABLE glyph_multi (name TEXT, code TEXT NOT NULL, data TEXT);
+    CREATE TABLE metadata (name TEXT, data TEXT);
+    CREATE UNIQUE INDEX glyph_multi_index ON glyph_multi (name, code);
+    CREATE UNIQUE INDEX meta_index ON metadata (name);
+    CREATE VIEW glyphs_multi AS SELECT name, code, data FROM glyph_multi;
+  `)
+  const blob = Buffer.from([65, 0, 1, 2, 3, 4, 5])
+  const insertGlyph = db.prepare('INSERT INTO glyph_multi (name, code, data) VALUES (?, ?, ?)')
+  insertGlyph.run('Roboto', '65', blob.toString('base64'))
+  insertGlyph.run(null, '66', blob.toString('base64'))
+  insertGlyph.run('Roboto', '67', null)
+  const insertMetadata = db.prepare('INSERT INTO metadata (name, data) VALUES (?, ?)')
+  insertMetadata.run(null, Buffer.from([1]).toString('base64'))
+  insertMetadata.run('Roboto', null)
+
+  migrateDatabase(db)
+
+  expect(db.pragma('user_version', { simple: true })).toEqual(SCHEMA_VERSION)
+  const tables = (db.prepare("SELECT name FROM sqlite_master WHERE type = 'table'").all() as Array<{ name: string }>).map(({ name }) => name)
+  expect(tables.filter(name => name.endsWith('_v1'))).toEqual([])
+  expect(getGlyph(db, '65', 'Roboto')).toEqual(blob)
+  // rows without a key or data are dropped
+  expect(db.prepare('SELECT count(*) AS count FROM glyph_multi').get()).toEqual({ count: 1 })
+  // metadata without a name is the single-map store's
+  expect(db.prepare('SELECT name, data FROM metadata').all()).toEqual([{ name: 'metadata', data: Buffer.from([1]) }])
+
+  // CLEANUP
+  db.close()
+  if (fs.existsSync(out)) fs.unlinkSync(out)
+})
+
+test('processing a font into a glyph pack', async (): Promise<void> => {
+  const name = 'Roboto'
+  const out = './tmp-process-roboto-pack'
+  await generateGlyphs({
+    name,
+    processOptions: {
+      fontPaths: ['./test/features/fonts/Roboto/Roboto-Medium.ttf']
+    },
+    convertOptions: {
+      convertType: 'mtsdf'
+    },
+    storeOptions: {
+      storeType: 'PACK',
+      out
+    }
+  })
+
+  const pack = new GlyphPackReader(`${out}/${name}.glyphs`)
+  expect(pack.metadata.size).toEqual(32)
+  expect(pack.metadata.channels).toEqual(4)
+  const blob = pack.getGlyph('65')
+  if (blob === undefined) throw new Error('glyph A is missing')
+  const { texW, texH, xOffset, yOffset, advanceWidth } = parseGlyphBuffer('65', blob)
+  expect(texW).toEqual(27)
+  expect(texH).toEqual(29)
+  expect(xOffset).toEqual(1391)
+  expect(yOffset).toEqual(1535)
+  expect(advanceWidth).toEqual(10904)
+  expect(pack.getGlyph('102.102.108')).toBeDefined()
+  expect(pack.getGlyph('65535')).toBeUndefined()
+  // aliases carry their own unicode in the header of the glyph they share
+  expect(pack.metadata.aliases.size).toBeGreaterThan(0)
+  for (const [unicode, target] of pack.metadata.aliases) {
+    const aliased = pack.getGlyph(String(unicode))
+    const shared = pack.getGlyph(String(target))
+    if (aliased === undefined || shared === undefined) throw new Error(`alias ${unicode} is missing`)
+    expect(parseGlyphBuffer(String(unicode), aliased).unicode).toEqual(unicode)
+    expect(aliased.subarray(2)).toEqual(shared.subarray(2))
+  }
+
+  // CLEANUP
+  fs.rmSync(out, { recursive: true, force: true })
+})
+
+test('glyph pack named codes are UTF-8', (): void => {
+  // UTF-16 puts the emoji before the fullwidth "!", UTF-8 bytes put it after; neither fits latin1
+  const ids = ['\uff01', '\u{1f600}', 'a', '\u56f3']
+  const glyphs = ids.map((id, i) => ({ type: 'image', id, dead: false, glyphBuffer: Buffer.from([i + 1]) }))
+  const map = { type: 'image', name: 'icons', glyphSet: new Set(ids), glyphs, defaultAdvance: 0, extent: 8192, size: 32, maxHeight: 0, range: 6 }
+  const pack = new GlyphPackReader(buildGlyphPack(map as unknown as Parameters<typeof buildGlyphPack>[0]))
+  ids.forEach((id, i) => { expect(pack.getGlyph(id)).toEqual(Buffer.from([i + 1])) })
+  expect(pack.getGlyph('\u56f4')).toBeUndefined()
+})
+
+test('metadata keeps more than 64 KiB of substitutes', (): void => {
+  // 12,000 three-component ligatures take 8 bytes each
+  const substitutes = Array.from({ length: 12_000 }, (_, i) => {
+    const components = [0x100 + (i % 200), 0x200 + Math.floor(i / 200), 0x300]
+    return { type: 4, substitute: components.join('.'), components, code: [4, 3, ...components] }
+  })
+  const map = { type: 'font', name: 'ligatures', glyphSet: new Set(), glyphs: [], substitutes, aliases: new Map(), defaultAdvance: 0, extent: 8192, size: 32, maxHeight: 0, range: 6 }
+  const metadata = parseMetadata(buildMetadata(map as unknown as Parameters<typeof buildMetadata>[0]))
+  expect(metadata.substitutes).toEqual(substitutes.map(({ type, substitute, components }) => ({ type, substitute, components })))
+  expect(metadata.channels).toEqual(4)
+})
+
+test('processing a font into range files', async (): Promise<void> => {
+  const name = 'Roboto'
+  const out = './tmp-process-roboto-ranges'
+  await generateGlyphs({
+    name,
+    processOptions: {
+      fontPaths: ['./test/features/fonts/Roboto/Roboto-Medium.ttf']
+    },
+    convertOptions: {
+      convertType: 'mtsdf'
+    },
+    storeOptions: {
+      storeType: 'RANGES',
+      out
+    }
+  })
+
+  expect(fs.existsSync(`${out}/${name}/metadata`)).toBeTruthy()
+  expect(fs.existsSync(`${out}/${name}/substitutes.pbf`)).toBeTruthy()
+  const glyphs = parseGlyphRange(fs.readFileSync(`${out}/${name}/0-255.pbf`))
+  const glyph = glyphs.find(g => g.unicode === 0x41)
+  if (glyph === undefined) throw new Error('glyph A is missing')
+  const { texW, texH, xOffset, yOffset, width, height, advanceWidth, channels } = glyph
+  expect(texW).toEqual(27)
+  expect(texH).toEqual(29)
+  expect(xOffset).toEqual(1391)
+  expect(yOffset).toEqual(1535)
+  expect(width).toEqual(6848)
+  expect(height).toEqual(7360)
+  expect(advanceWidth).toEqual(10904)
+  expect(channels).toEqual(4)
+
+  // CLEANUP
+  fs.rmSync(out, { recursive: true, force: true })
+})
+
 test('processing a single icon into SQL', async (): Promise<void> => {
   const name = 'single'
   const out = './tmp-process-single-sdf.sqlite'
@@ -109,12 +282,15 @@ test('processing a single icon into SQL', async (): Promise<void> => {
     storeOptions: {
       storeType: 'SQL',
       out,
-      multi: true
+      multi: true,
+      finalize: true
     }
   })
 
   const db = new Database(out, { readonly: true })
   db.exec(SCHEMA)
+  // finalized: compacted and analyzed
+  expect(db.prepare('SELECT tbl FROM sqlite_stat1').pluck().all()).toContain('glyph_multi')
 
   const metadata = getMetadata(db, name)
   if (metadata === undefined) throw new Error('metadata is undefined')
@@ -228,3 +404,38 @@ test('processing an icon set into SQL', async (): Promise<void> => {
   if (fs.existsSync(`${out}-shm`)) fs.unlinkSync(`${out}-shm`)
   if (fs.existsSync(`${out}-wal`)) fs.unlinkSync(`${out}-wal`)
 })
+
+test('processing icons into a sprite sheet', async (): Promise<void> => {
+  const name = 'streets'
+  const out = './tmp-process-streets-sprites'
+  await generateGlyphs({
+    name,
+    processOptions: {
+      svgFolder: './test/features/svgs/streets-mini'
+    },
+    convertOptions: {
+      convertType: 'mtsdf'
+    },
+    storeOptions: {
+      storeType: 'SPRITESHEET',
+      out,
+      pageSize: 512
+    }
+  })
+
+  const index = JSON.parse(fs.readFileSync(`${out}/${name}/index.json`, 'utf8'))
+  expect(index.pageWidth).toEqual(512)
+  expect(index.channels).toEqual(4)
+  expect(index.pages).toBeGreaterThan(0)
+  for (const { page, x, y, texW, texH } of Object.values(index.glyphs) as Array<Record<string, number>>) {
+    expect(page).toBeLessThan(index.pages)
+    expect(x + texW).toBeLessThanOrEqual(512)
+    expect(y + texH).toBeLessThanOrEqual(512)
+  }
+  const { width, height } = await sharp(`${out}/${name}/0.png`).metadata()
+  expect(width).toEqual(512)
+  expect(height).toEqual(512)
+
+  // CLEANUP
+  fs.rmSync(out, { recursive: true, force: true })
+})
@@ -1,6 +1,8 @@
 import fs from 'fs'
+import os from 'os'
+import path from 'path'
 import { describe, it, expect } from 'vitest'
-import { buildFontGlyph } from '../dist'
+import { buildFontGlyph, buildFontGlyphs, buildFontGlyphsAsync, buildSVGGlyph, buildSVGGlyphs, buildSVGGlyphsAsync, compareQuadraticSearch, FontSession, pruneGlyphCache } from '../dist'
 
 describe('buildFontGlyph tests', async (): Promise<void> => {
   it('SDF test', async (): Promise<void> => {
@@ -67,4 +69,155 @@ describe('buildFontGlyph tests', async (): Promise<void> => {
     // compare
     expect(mtsdfu8).toEqual(mtsdfImageu8)
   })
+  it('FontSession matches buildFontGlyph', async (): Promise<void> => {
+    const session = new FontSession('./test/features/fonts/Roboto/Roboto-Medium.ttf')
+    for (const type of ['sdf', 'psdf', 'msdf', 'mtsdf'] as const) {
+      const glyph = session.buildGlyph(0x41, 32, 6, type, false)
+      const u8 = new Uint8Array(glyph.data)
+      // grab image to compare
+      const imageu8 = new Uint8Array(fs.readFileSync(`./test/features/glyphs/${type}.raw`))
+      // compare
+      expect(u8).toEqual(imageu8)
+    }
+    session.close()
+    expect(() => session.buildGlyph(0x41, 32, 6, 'sdf', false)).toThrow()
+  })
+  it('buildFontGlyphs matches buildFontGlyph', async (): Promise<void> => {
+    const codes = new Uint32Array([0x41, 0x20, 0x41])
+    const flags = new Uint8Array(codes.length)
+    for (const type of ['sdf', 'psdf', 'msdf', 'mtsdf'] as const) {
+      const { data, sizes } = buildFontGlyphs(
+        './test/features/fonts/Roboto/Roboto-Medium.ttf',
+        codes,
+        flags,
+        32,
+        6,
+        type
+      )
+      const imageu8 = new Uint8Array(fs.readFileSync(`./test/features/glyphs/${type}.raw`))
+      // the space has no shape to render
+      expect(sizes[1 * 4 + 2]).toEqual(-1)
+      for (const index of [0, 2]) {
+        const offset = sizes[index * 4 + 2]
+        const length = sizes[index * 4 + 3]
+        expect(new Uint8Array(data, offset, length)).toEqual(imageu8)
+      }
+    }
+  })
+  it('buildFontGlyphs is independent of the thread count', async (): Promise<void> => {
+    const codes = new Uint32Array(Array.from({ length: 64 }, (_, i) => 0x21 + i))
+    const flags = new Uint8Array(codes.length)
+    const font = './test/features/fonts/Roboto/Roboto-Medium.ttf'
+    const single = buildFontGlyphs(font, codes, flags, 32, 6, 'msdf', 1)
+    const multi = buildFontGlyphs(font, codes, flags, 32, 6, 'msdf', 4)
+    expect(new Uint8Array(multi.data)).toEqual(new Uint8Array(single.data))
+    expect(multi.sizes).toEqual(single.sizes)
+    expect(multi.metrics).toEqual(single.metrics)
+    // reserved header room shifts every glyph without changing its pixels
+    const withHeader = buildFontGlyphs(font, codes, flags, 32, 6, 'msdf', 1, 14)
+    expect(withHeader.sizes[2]).toEqual(14)
+    expect(new Uint8Array(withHeader.data, 14, withHeader.sizes[3])).toEqual(new Uint8Array(single.data, 0, single.sizes[3]))
+  })
+  it('buildFontGlyphsAsync matches buildFontGlyphs', async (): Promise<void> => {
+    const codes = new Uint32Array(Array.from({ length: 64 }, (_, i) => 0x21 + i))
+    const flags = new Uint8Array(codes.length)
+    const font = './test/features/fonts/Roboto/Roboto-Medium.ttf'
+    const progress: number[] = []
+    const sync = buildFontGlyphs(font, codes, flags, 32, 6, 'mtsdf')
+    const background = await buildFontGlyphsAsync(font, codes, flags, 32, 6, 'mtsdf', 2, 0, (done) => progress.push(done))
+    expect(new Uint8Array(background.data)).toEqual(new Uint8Array(sync.data))
+    expect(background.sizes).toEqual(sync.sizes)
+    expect(background.metrics).toEqual(sync.metrics)
+    expect(progress.length).toBeGreaterThan(0)
+    await expect(buildFontGlyphsAsync('./missing.ttf', codes, flags, 32, 6, 'sdf')).rejects.toThrow()
+  })
+  it('buildFontGlyphs packed output keeps only the type channels', async (): Promise<void> => {
+    const codes = new Uint32Array([0x41])
+    const flags = new Uint8Array(codes.length)
+    const font = './test/features/fonts/Roboto/Roboto-Medium.ttf'
+    for (const [type, channels] of [['sdf', 1], ['msdf', 3]] as const) {
+      const { data, sizes, channels: batchChannels } = buildFontGlyphs(font, codes, flags, 32, 6, type, 1, 0, true)
+      expect(batchChannels).toEqual(channels)
+      expect(sizes[3]).toEqual(sizes[0] * sizes[1] * channels)
+      // same texels as the RGBA reference, minus the padding
+      const rgba = new Uint8Array(fs.readFileSync(`./test/features/glyphs/${type}.raw`))
+      const expected = new Uint8Array(sizes[3])
+      for (let i = 0; i < sizes[0] * sizes[1]; i++) {
+        for (let c = 0; c < channels; c++) expected[i * channels + c] = rgba[i * 4 + c]
+      }
+      expect(new Uint8Array(data, sizes[2], sizes[3])).toEqual(expected)
+    }
+  })
+  it('buildFontGlyph packed output keeps only the type channels', async (): Promise<void> => {
+    const font = './test/features/fonts/Roboto/Roboto-Medium.ttf'
+    const session = new FontSession(font)
+    for (const [type, channels] of [['sdf', 1], ['msdf', 3]] as const) {
+      const glyph = buildFontGlyph(font, 0x41, 32, 6, type, false, true)
+      expect(glyph.channels).toEqual(channels)
+      const rgba = new Uint8Array(fs.readFileSync(`./test/features/glyphs/${type}.raw`))
+      const expected = new Uint8Array(glyph.width * glyph.height * channels)
+      for (let i = 0; i < glyph.width * glyph.height; i++) {
+        for (let c = 0; c < channels; c++) expected[i * channels + c] = rgba[i * 4 + c]
+      }
+      expect(new Uint8Array(glyph.data)).toEqual(expected)
+      expect(new Uint8Array(session.buildGlyph(0x41, 32, 6, type, false, true).data)).toEqual(expected)
+    }
+    session.close()
+  })
+  it('buildSVGGlyphs matches buildSVGGlyph', async (): Promise<void> => {
+    const svg = './test/features/svgs/streets-mini/amusement-park.svg'
+    // an index past the last path fails on its own without affecting the rest
+    const indices = new Uint32Array([0, 3, 2, 99])
+    const { data, sizes, metrics } = buildSVGGlyphs(svg, indices, 32, 6, 'msdf')
+    for (let i = 0; i < 3; i++) {
+      const single = buildSVGGlyph(svg, 32, 6, indices[i] + 1, 'msdf')
+      expect(sizes[i * 4 + 0]).toEqual(single.width)
+      expect(sizes[i * 4 + 1]).toEqual(single.height)
+      expect(metrics[i * 6 + 1]).toEqual(single.l)
+      expect(new Uint8Array(data, sizes[i * 4 + 2], sizes[i * 4 + 3])).toEqual(new Uint8Array(single.data))
+    }
+    expect(sizes[3 * 4 + 2]).toEqual(-1)
+    const background = await buildSVGGlyphsAsync(svg, indices, 32, 6, 'msdf')
+    expect(new Uint8Array(background.data)).toEqual(new Uint8Array(data))
+    await expect(buildSVGGlyphsAsync('./missing.svg', indices, 32, 6, 'sdf')).rejects.toThrow()
+  })
+  it('cubic curves render the same whatever order pixels are visited in', async (): Promise<void> => {
+    // a path of cubics, rendered whole and as part of a multithreaded batch
+    const svg = './test/features/svgs/streets-mini/amusement-park.svg'
+    const imageu8 = new Uint8Array(fs.readFileSync('./test/features/glyphs/amusement-park-msdf.raw'))
+    expect(new Uint8Array(buildSVGGlyph(svg, 128, 6, 4, 'msdf').data)).toEqual(imageu8)
+    const { data, sizes } = buildSVGGlyphs(svg, new Uint32Array([3]), 128, 6, 'msdf', 2)
+    expect(new Uint8Array(data, sizes[2], sizes[3])).toEqual(imageu8)
+  })
+  it('quadratic curves render the same with the seeded closest-point search', async (): Promise<void> => {
+    // the seeded search is on by default because its 8-bit output matches solving the cubic equation
+    const indices = new Uint32Array(Array.from({ length: 512 }, (_, i) => i))
+    for (const type of ['msdf', 'mtsdf'] as const) {
+      const { glyphs, differingBytes, maxDifference } = compareQuadraticSearch('./test/features/fonts/Roboto/Roboto-Medium.ttf', indices, 64, 6, type)
+      expect(glyphs).toBeGreaterThan(0)
+      expect(differingBytes).toEqual(0)
+      expect(maxDifference).toEqual(0)
+    }
+    expect(() => compareQuadraticSearch('./missing.ttf', indices, 64, 6, 'msdf')).toThrow()
+  })
+  it('buildFontGlyphs render cache returns the same pixels', async (): Promise<void> => {
+    const codes = new Uint32Array(Array.from({ length: 16 }, (_, i) => 0x41 + i))
+    const flags = new Uint8Array(codes.length)
+    const font = './test/features/fonts/Roboto/Roboto-Medium.ttf'
+    const cacheDir = fs.mkdtempSync(path.join(os.tmpdir(), 'glyph-cache-'))
+    const uncached = buildFontGlyphs(font, codes, flags, 32, 6, 'mtsdf', 1, 14)
+    const cold = buildFontGlyphs(font, codes, flags, 32, 6, 'mtsdf', 1, 14, false, cacheDir)
+    const entries = fs.readdirSync(cacheDir).length
+    expect(entries).toEqual(codes.length)
+    const warm = buildFontGlyphs(font, codes, flags, 32, 6, 'mtsdf', 1, 14, false, cacheDir)
+    expect(new Uint8Array(cold.data)).toEqual(new Uint8Array(uncached.data))
+    expect(new Uint8Array(warm.data)).toEqual(new Uint8Array(uncached.data))
+    expect(fs.readdirSync(cacheDir).length).toEqual(entries)
+    // other parameters are other entries
+    buildFontGlyphs(font, codes, flags, 48, 6, 'mtsdf', 1, 14, false, cacheDir)
+    expect(fs.readdirSync(cacheDir).length).toEqual(2 * entries)
+    expect(pruneGlyphCache(cacheDir, 0)).toEqual(0)
+    expect(fs.readdirSync(cacheDir).length).toEqual(0)
+    fs.rmSync(cacheDir, { recursive: true, force: true })
+  })
 })
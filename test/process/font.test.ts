@@ -71,3 +71,17 @@ test('test processing a font', async (): Promise<void> => {
     code: 640
   })
 })
+
+test('code points sharing an outline are stored once', async (): Promise<void> => {
+  const data = await processFont('robotoMedium', {
+    fontPaths: ['./test/features/fonts/Roboto/Roboto-Medium.ttf']
+  })
+  const stored = new Map<number, boolean>()
+  for (const glyph of data.glyphs) if (glyph.type === 'unicode') stored.set(glyph.unicode, glyph.dead)
+  expect(data.aliases.size).toBeGreaterThan(0)
+  for (const [unicode, target] of data.aliases) {
+    expect(stored.has(unicode)).toBe(false)
+    expect(stored.get(target)).toBe(false)
+    expect(data.glyphSet.has(String(unicode))).toBe(true)
+  }
+})